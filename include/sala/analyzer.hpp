@@ -6,6 +6,11 @@
 #   include <unordered_map>
 #   include <vector>
 #   include <functional>
+#   include <bitset>
+#   include <initializer_list>
+#   include <type_traits>
+#   include <cstddef>
+#   include <new>
 
 #   define REGISTER_EXTERN_FUNCTION_PROCESSOR(FN_NAME, IMPL) register_extern_function_processor(#FN_NAME, [this]() { IMPL; })
 
@@ -15,17 +20,48 @@ namespace sala {
 
 struct Analyzer : public InstrSwitch
 {
-    using PostOperation = std::function<void()>;
-
-    explicit Analyzer(ExecState* state);
+    // A callable stored inline, i.e., without any allocation. It accepts only
+    // trivially copyable callables of a small size, e.g., lambdas capturing
+    // 'this' and a few pointers or numbers.
+    struct PostOperation final
+    {
+        PostOperation() : invoke_{ nullptr }, storage_{} {}
+        PostOperation(std::nullptr_t) : PostOperation{} {}
+        template<typename F>
+        PostOperation(F const& callable) : invoke_{ [](void* const storage) { (*static_cast<F*>(storage))(); } }, storage_{}
+        {
+            static_assert(std::is_trivially_copyable_v<F>, "The post operation must be trivially copyable.");
+            static_assert(sizeof(F) <= sizeof(storage_), "The post operation is too big.");
+            static_assert(alignof(F) <= alignof(std::max_align_t), "The post operation is over-aligned.");
+            new (storage_) F{ callable };
+        }
+
+        explicit operator bool() const { return invoke_ != nullptr; }
+        void operator()() { invoke_(storage_); }
+
+    private:
+        void (*invoke_)(void*);
+        alignas(std::max_align_t) unsigned char storage_[4ULL * sizeof(void*)];
+    };
+    using OpcodeMask = std::bitset<(std::size_t)Instruction::Opcode::VA_COPY + 1ULL>;
+
+    static OpcodeMask all_opcodes() { return OpcodeMask{}.set(); }
+    static OpcodeMask opcodes(std::initializer_list<Instruction::Opcode> list);
+
+    // The analyzer is called (pre and post) only for instructions whose
+    // opcodes are in the passed mask. Other instructions are skipped.
+    explicit Analyzer(ExecState* state, OpcodeMask const& interests = all_opcodes());
     virtual ~Analyzer() {}
 
+    OpcodeMask const& interests() const { return interests_; }
+    bool is_interested(Instruction::Opcode const opcode) const { return interests_.test((std::size_t)opcode); }
+
     ExecState const& state() const { return *state_; }
     ExecState& state() { return *state_; }
 
     Program const& program() const { return state().program(); }
     Instruction const& instruction() const override { return state().current_instruction(); }
-    std::vector<MemBlock const*> const& operands() const override { return state().current_operands(); }
+    Operands const& operands() const override { return state().current_operands(); }
     std::vector<MemBlock> const& parameters() { return stack_top().parameters(); }
     StackRecord const& stack_top() const { return state().stack_top(); }
     InstrPointer const& ip() const { return stack_top().ip(); }
@@ -34,7 +70,7 @@ struct Analyzer : public InstrSwitch
 
     virtual void on_stack_initialized() {}
 
-    void pre() { post_operation_ = nullptr; do_instruction_switch(); }
+    void pre() { post_operation_ = nullptr; do_instruction_switch(state().current_decoded_instruction()); }
     void post() { if (post_operation_) post_operation_(); }
 
     void register_extern_function_processor(std::string const& function_name, std::function<void()> const& code);
@@ -42,6 +78,7 @@ struct Analyzer : public InstrSwitch
 
 private:
     ExecState* state_;
+    OpcodeMask interests_;
     PostOperation post_operation_;
     std::unordered_map<std::string, std::function<void()> > extern_function_processors_;
 };
@@ -0,0 +1,96 @@
+#ifndef SALA_AOT_HPP_INCLUDED
+#   define SALA_AOT_HPP_INCLUDED
+
+#   include <sala/decoded_program.hpp>
+#   include <sala/jit.hpp>
+#   include <memory>
+#   include <string>
+#   include <vector>
+#   include <cstdint>
+
+namespace sala {
+
+
+// Native code of basic blocks of a program compiled ahead of time. The program
+// is translated to a C++ translation unit, which is built by the system compiler
+// to a shared library and loaded by dlopen. The libraries are cached in a directory
+// under the hash of the translation, the compiler and its flags, so a program is
+// built only once. The cache directory must be owned by the user and writable only
+// by the user (a missing one is created so), because the libraries in it are loaded
+// into the process. The library knows the hash of its program (see hash_program()),
+// so a module cannot be used with another program.
+//
+// The translated blocks obey the contract of blocks compiled by Jit, i.e., they
+// consist only of instructions which cannot terminate the execution, call anything
+// or change the stack, and they end with JUMP or BRANCH. Everything else stays
+// for the interpreter (see Interpreter::enable_aot()), so the termination and the
+// report of the execution state do not change. Besides the instructions of Jit,
+// the translation supports all integer widths and floating point ADD, SUB, MUL and
+// ordered comparisons, and COPY of any size.
+struct AotModule final
+{
+    struct Options
+    {
+        // Empty means the directory 'sala_aot_<user id>' in the temporary directory.
+        std::string cache_dir{};
+        // Empty means the environment variable CXX, or 'c++'. It is the path (or the name
+        // searched in PATH) of the compiler, which is run without a shell.
+        std::string compiler{};
+        // The flags are passed to the compiler as separate arguments split at white space.
+        std::string compiler_flags{ "-O2 -ffp-contract=off" };
+    };
+
+    struct Block
+    {
+        std::uint32_t func_idx;
+        std::uint32_t block_idx;
+        std::uint32_t num_instructions;
+        Jit::Code code;
+    };
+
+    static bool is_supported();
+
+    // Returns the hash of the program, see program_hash().
+    static std::uint64_t hash_program(DecodedProgram const& program);
+
+    // Returns the C++ translation unit of the program.
+    static std::string translate(DecodedProgram const& program);
+
+    // Returns the module of the program, builds it first if it is not in the cache.
+    // Returns nullptr, if the module cannot be built or loaded. The error is then
+    // written to 'error_message', if it is not nullptr.
+    static std::shared_ptr<AotModule const> load(
+        DecodedProgram const& program,
+        Options const& options,
+        std::string* error_message = nullptr
+        );
+    static std::shared_ptr<AotModule const> load(DecodedProgram const& program) { return load(program, Options{}); }
+
+    ~AotModule();
+    AotModule(AotModule const&) = delete;
+    AotModule& operator=(AotModule const&) = delete;
+
+    // The hash of the translation, the compiler and its flags.
+    std::uint64_t hash() const { return hash_; }
+    // The hash of the program the module was built for (see hash_program()).
+    std::uint64_t program_hash() const { return program_hash_; }
+    std::string const& path() const { return path_; }
+    std::vector<Block> const& blocks() const { return blocks_; }
+
+private:
+    // The layout of an entry of the table of blocks in the built library.
+    struct Entry;
+
+    AotModule(std::uint64_t hash, std::uint64_t program_hash, std::string const& path, void* handle);
+
+    std::uint64_t hash_;
+    std::uint64_t program_hash_;
+    std::string path_;
+    void* handle_;
+    std::vector<Block> blocks_;
+};
+
+
+}
+
+#endif
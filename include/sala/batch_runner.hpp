@@ -0,0 +1,77 @@
+#ifndef SALA_BATCH_RUNNER_HPP_INCLUDED
+#   define SALA_BATCH_RUNNER_HPP_INCLUDED
+
+#   include <sala/program.hpp>
+#   include <sala/decoded_program.hpp>
+#   include <sala/exec_state.hpp>
+#   include <sala/interpreter.hpp>
+#   include <functional>
+#   include <memory>
+#   include <string>
+#   include <vector>
+#   include <cstdint>
+
+namespace sala {
+
+
+// Runs a program on many inputs in parallel. Each worker thread has its own
+// ExecState (with ExternCodeCStd, optionally Sanitizer, and Interpreter). The
+// worker runs the static initializer once, takes a snapshot of the state at the
+// start of the entry function and restores it before each of its inputs (see
+// ExecState::set_command_line()). So the budget and the number of steps of an
+// input do not include the static initializer. All states share the decoded
+// program and so also the constants. The inputs are distributed to queues of the
+// workers in contiguous ranges and an idle worker steals from the back of the
+// queue of another one. The program is shared by all workers, so it must be
+// frozen (see Program::freeze()).
+struct BatchRunner final
+{
+    struct Input
+    {
+        // The command line arguments, including the program name.
+        std::vector<std::string> args{};
+        Interpreter::Budget budget{};
+    };
+
+    struct Result
+    {
+        // The index of the input.
+        std::size_t index{ 0ULL };
+        ExecState::Termination termination{ ExecState::Termination::UNKNOWN };
+        std::int32_t exit_code{ 0 };
+        std::uint64_t num_steps{ 0ULL };
+        std::string report{};
+    };
+
+    // It is called from the worker threads, but never concurrently.
+    using Callback = std::function<void(Result const&)>;
+
+    // Zero threads means the number of hardware threads.
+    explicit BatchRunner(
+        Program const* P,
+        std::size_t num_threads = 0ULL,
+        bool sanitize = true,
+        std::size_t memory_size_in_bytes = 0ULL
+        );
+
+    std::size_t num_threads() const { return num_threads_; }
+
+    // Returns the results in the order of the inputs.
+    std::vector<Result> run(std::vector<Input> const& inputs) const;
+    // Passes the results to the callback in the order of completion.
+    void run(std::vector<Input> const& inputs, Callback const& callback) const;
+
+private:
+    struct WorkQueue;
+    struct Worker;
+
+    std::shared_ptr<DecodedProgram const> decoded_program_;
+    std::size_t num_threads_;
+    bool sanitize_;
+    std::size_t memory_size_in_bytes_;
+};
+
+
+}
+
+#endif
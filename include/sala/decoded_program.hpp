@@ -0,0 +1,133 @@
+#ifndef SALA_DECODED_PROGRAM_HPP_INCLUDED
+#   define SALA_DECODED_PROGRAM_HPP_INCLUDED
+
+#   include <sala/program.hpp>
+#   include <sala/instr_switch.hpp>
+#   include <array>
+#   include <vector>
+#   include <memory>
+#   include <cstdint>
+
+namespace sala {
+
+
+struct DecodedOperand final
+{
+    Instruction::Descriptor descriptor{ Instruction::Descriptor::LOCAL };
+    std::uint32_t index{ 0U };
+    std::size_t num_bytes{ 0ULL };
+};
+
+
+struct DecodedInstruction final
+{
+    // A fusion marks the instruction as the first one of a short sequence of instructions
+    // in the same basic block, which can be executed as a single operation. Execution of
+    // any instruction of the sequence separately (i.e., unfused) is always valid too.
+    enum struct Fusion : std::uint8_t
+    {
+        NONE,
+        // LESS/LESS_EQUAL/GREATER/GREATER_EQUAL/EQUAL/UNEQUAL vN ...; BRANCH vN
+        COMPARE_BRANCH,
+        // LOAD vN vP; ADD/SUB/MUL/AND/OR/XOR/SHL/SHR vM ... vN ...; STORE vP vM
+        LOAD_COMPUTE_STORE,
+        // ADDRESS vA xB; MOVEPTR vP vA ...; LOAD vN vP
+        ADDRESS_MOVEPTR_LOAD
+    };
+
+    // The method of InstrSwitch to be called for the instruction. It is nullptr,
+    // if the instruction could not be decoded (e.g., __INVALID__ instruction).
+    InstrSwitch::Handler handler{ nullptr };
+    // The index of the instruction among all instructions of the program, e.g., for
+    // tables of data per instruction kept by an InstrSwitch.
+    std::uint32_t index{ 0U };
+    bool transfers_control{ false };
+    // True for CALL and RET, i.e., for instructions pushing or popping a stack record.
+    bool changes_stack{ false };
+    Fusion fusion{ Fusion::NONE };
+    Instruction const* instruction{ nullptr };
+    // The range of operands of the instruction in DecodedFunction::operands().
+    std::uint32_t operands_begin{ 0U };
+    std::uint32_t operands_end{ 0U };
+    // Indices of the successor blocks for JUMP and BRANCH instructions.
+    std::array<std::uint32_t, 2> successors{ 0U, 0U };
+    // The bytes of the last operand, if it is a constant of at most 8 bytes, so that
+    // a handler can read them without going through the memory block.
+    std::uint64_t immediate{ 0ULL };
+    // For CALL through a function pointer, the index of the instruction among all
+    // such instructions of the program, see ExecState::call_target().
+    std::uint32_t call_site{ 0U };
+};
+
+
+struct DecodedFunction final
+{
+    // The instructions and the indirect call sites of the function are numbered
+    // from 'first_instruction' and 'first_call_site' respectively.
+    DecodedFunction(Program const& P, Function const& F, std::uint32_t first_instruction = 0U, std::uint32_t first_call_site = 0U);
+
+    Function const& function() const { return *function_; }
+    std::vector<DecodedInstruction> const& instructions() const { return instructions_; }
+    std::vector<DecodedOperand> const& operands() const { return operands_; }
+    std::uint32_t num_call_sites() const { return num_call_sites_; }
+    // The value of Function::initial_stack_bytes(), computed once by the decoding.
+    std::size_t initial_stack_bytes() const { return initial_stack_bytes_; }
+    DecodedInstruction const* block(std::uint32_t const block_idx) const { return instructions_.data() + blocks_[block_idx]; }
+    DecodedInstruction const& instruction(std::uint32_t const block_idx, std::uint32_t const instr_idx) const
+    { return block(block_idx)[instr_idx]; }
+
+    // The count of instructions executed by a fused operation (see DecodedInstruction::Fusion).
+    static std::uint32_t num_fused_instructions(DecodedInstruction::Fusion fusion);
+
+private:
+
+    bool same_operand(DecodedInstruction const& left, std::uint32_t left_idx, DecodedInstruction const& right, std::uint32_t right_idx) const;
+    DecodedInstruction::Fusion detect_fusion(DecodedInstruction const* first, DecodedInstruction const* end) const;
+
+    Function const* function_;
+    std::vector<DecodedInstruction> instructions_;
+    std::vector<std::uint32_t> blocks_;
+    std::vector<DecodedOperand> operands_;
+    std::uint32_t num_call_sites_;
+    std::size_t initial_stack_bytes_;
+};
+
+
+struct DecodedProgram final
+{
+    explicit DecodedProgram(Program const& P);
+
+    Program const& program() const { return *program_; }
+    std::vector<DecodedFunction> const& functions() const { return functions_; }
+    DecodedFunction const& function(std::uint32_t const func_idx) const { return functions_[func_idx]; }
+    std::uint32_t num_instructions() const { return num_instructions_; }
+    // The count of CALL instructions through a function pointer in the program.
+    std::uint32_t num_call_sites() const { return num_call_sites_; }
+
+    // The bytes of all constants of the program in one buffer of read-only pages, i.e.,
+    // any write to a constant crashes. Execution states sharing the decoded program
+    // view their constants there instead of copying them. The constant of index i
+    // starts at constant_offsets()[i].
+    std::uint8_t const* constant_bytes() const { return constant_bytes_.get(); }
+    std::vector<std::size_t> const& constant_offsets() const { return constant_offsets_; }
+
+private:
+    // Releases the pages of the constant bytes.
+    struct ConstantBytesDeleter
+    {
+        std::size_t num_bytes;
+        void operator()(std::uint8_t* bytes) const;
+    };
+
+    Program const* program_;
+    std::vector<DecodedFunction> functions_;
+    std::uint32_t num_instructions_;
+    std::uint32_t num_call_sites_;
+    std::unique_ptr<std::uint8_t[], ConstantBytesDeleter> constant_bytes_;
+    std::vector<std::size_t> constant_offsets_;
+};
+
+
+}
+
+#endif
@@ -3,16 +3,54 @@
 
 #   include <sala/program.hpp>
 #   include <sala/memblock.hpp>
+#   include <sala/heap.hpp>
 #   include <sala/pointer_model.hpp>
+#   include <array>
 #   include <vector>
 #   include <unordered_map>
 #   include <unordered_set>
 #   include <memory>
+#   include <stdexcept>
 #   include <cstdint>
 
 namespace sala {
 
 
+struct DecodedProgram;
+struct DecodedFunction;
+struct DecodedInstruction;
+
+
+// A view of the memory blocks of operands of an instruction.
+struct Operands final
+{
+    using value_type = MemBlock const*;
+    using const_iterator = MemBlock const* const*;
+
+    Operands() : begin_{ nullptr }, end_{ nullptr } {}
+    Operands(const_iterator const begin, const_iterator const end) : begin_{ begin }, end_{ end } {}
+
+    const_iterator begin() const { return begin_; }
+    const_iterator end() const { return end_; }
+    std::size_t size() const { return (std::size_t)(end_ - begin_); }
+    bool empty() const { return begin_ == end_; }
+
+    MemBlock const* front() const { return *begin_; }
+    MemBlock const* back() const { return *(end_ - 1); }
+    MemBlock const* operator[](std::size_t const i) const { return begin_[i]; }
+    MemBlock const* at(std::size_t const i) const
+    {
+        if (i >= size())
+            throw std::out_of_range("sala::Operands::at()");
+        return begin_[i];
+    }
+
+private:
+    const_iterator begin_;
+    const_iterator end_;
+};
+
+
 struct InstrPointer final
 {
     InstrPointer();
@@ -33,6 +71,7 @@ struct StackRecord final
 {
     StackRecord();
     explicit StackRecord(PointerModel* pointer_model, Function const& F);
+    StackRecord(MemBlockAllocator* allocator, PointerModel* pointer_model, Function const& F);
 
     std::uint32_t function_index() const { return function_index_; }
     InstrPointer const& ip() const { return ip_; }
@@ -47,13 +86,81 @@ struct StackRecord final
     void push_back_local_variable(std::size_t num_bytes);
     void pop_back_local_variable();
 
+    // Prepares the record of a finished call of the function for a new call of it. The
+    // memory of parameters and locals is kept (so is the operand table) and filled with
+    // 'init_value' like in a new record. Returns false, if the record cannot be reused.
+    bool reset(Function const& F, std::uint8_t init_value = 0xcd);
+
+    // Memory blocks of all operands of all instructions of the function, in the
+    // order of DecodedFunction::operands(). It is built by ExecState on the first
+    // use of the record. It is cleared whenever the addresses of locals change.
+    std::vector<MemBlock const*> const& operand_table() const { return operand_table_; }
+    std::vector<MemBlock const*>& operand_table() { return operand_table_; }
+
 private:
+    MemBlockAllocator* allocator_;
     PointerModel* pointer_model_;
     std::uint32_t function_index_;
     InstrPointer ip_;
     std::vector<MemBlock> parameters_;
     std::vector<MemBlock> locals_;
     std::vector<MemBlock> variadic_parameters_;
+    std::vector<MemBlock const*> operand_table_;
+};
+
+
+// The stack of records of called functions. The records are stored in chunks of
+// a fixed size, which are never reallocated. So the growth of the stack moves no
+// record and the address of a record is stable while the record is in the stack.
+struct StackSegment final
+{
+    template<typename Owner, typename Record>
+    struct Iterator
+    {
+        Iterator(Owner* const owner, std::size_t const index) : owner_{ owner }, index_{ index } {}
+        Record& operator*() const { return (*owner_)[index_]; }
+        Record* operator->() const { return &(*owner_)[index_]; }
+        Iterator& operator++() { ++index_; return *this; }
+        bool operator==(Iterator const& other) const { return index_ == other.index_; }
+        bool operator!=(Iterator const& other) const { return index_ != other.index_; }
+    private:
+        Owner* owner_;
+        std::size_t index_;
+    };
+    using iterator = Iterator<StackSegment, StackRecord>;
+    using const_iterator = Iterator<StackSegment const, StackRecord const>;
+
+    StackSegment();
+    StackSegment(StackSegment const& other);
+    StackSegment& operator=(StackSegment const& other);
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0ULL; }
+
+    StackRecord const& operator[](std::size_t const i) const { return chunks_[i >> chunk_bits][i & (chunk_size - 1ULL)]; }
+    StackRecord& operator[](std::size_t const i) { return chunks_[i >> chunk_bits][i & (chunk_size - 1ULL)]; }
+    StackRecord const& at(std::size_t i) const;
+    StackRecord& at(std::size_t i);
+    StackRecord const& back() const { return *top_; }
+    StackRecord& back() { return *top_; }
+
+    const_iterator begin() const { return { this, 0ULL }; }
+    const_iterator end() const { return { this, size_ }; }
+    iterator begin() { return { this, 0ULL }; }
+    iterator end() { return { this, size_ }; }
+
+    void push_back(StackRecord&& record);
+    // Moves the top record out of the stack.
+    StackRecord pop_back();
+    void clear();
+
+private:
+    static constexpr std::size_t chunk_bits{ 6ULL };
+    static constexpr std::size_t chunk_size{ 1ULL << chunk_bits };
+
+    std::vector<std::unique_ptr<StackRecord[]> > chunks_;
+    std::size_t size_;
+    StackRecord* top_;
 };
 
 
@@ -75,14 +182,64 @@ struct ExecState final
         CRASH   = 2
     };
 
+    // A copy of the memory and the stack of a state (see snapshot() and restore()).
+    // It keeps all memory blocks of the state alive, so restoring puts them back
+    // at the same addresses and pointers stored in memory stay valid. A snapshot
+    // can only be restored to the state which created it and it must be destroyed
+    // before the state. With MemBlockAllocatorFlat with enabled tracking of writes
+    // (see MemBlockAllocatorFlat::track_writes()) the restore of the most recent
+    // snapshot copies back only the bytes in the dirty pages.
+    struct Snapshot final
+    {
+        Stage stage() const { return stage_; }
+
+    private:
+        friend struct ExecState;
+
+        ExecState const* state_;
+        Stage stage_;
+        Termination termination_;
+        std::string terminator_;
+        std::string error_message_;
+        Instruction const* termination_instruction_;
+        std::unordered_set<std::string> warnings_;
+        StackSegment stack_segment_;
+        std::vector<MemBlock> heap_segment_;
+        std::size_t stack_exit_depth_;
+        std::vector<std::uint32_t> atexit_stack_;
+        std::vector<MemBlock> blocks_;
+        std::vector<std::size_t> offsets_;
+        std::vector<std::uint8_t> bytes_;
+        // For each tracked page the indices of the blocks in it, in the
+        // compressed form: blocks of page i are page_blocks_[page_begins_[i]...page_begins_[i+1]).
+        std::uint64_t tracking_epoch_;
+        std::vector<std::uint32_t> page_begins_;
+        std::vector<std::uint32_t> page_blocks_;
+    };
+
     ExecState(Program const* P, int argc, char* argv[], std::size_t memory_size_in_bytes);
+    // The allocator provides memory for all memory blocks of the state. With
+    // MemBlockAllocatorFlat all segments share one contiguous region and
+    // 32-bit programs use offsets in the region as pointers.
+    ExecState(
+        std::shared_ptr<DecodedProgram const> D,
+        int argc,
+        char* argv[],
+        std::size_t memory_size_in_bytes,
+        std::unique_ptr<MemBlockAllocator> allocator
+        );
+    ExecState(std::shared_ptr<DecodedProgram const> D, int argc, char* argv[], std::size_t memory_size_in_bytes);
+    ExecState(std::shared_ptr<DecodedProgram const> D, int argc, char* argv[]) : ExecState{ D, argc, argv, 0ULL } {}
+    explicit ExecState(std::shared_ptr<DecodedProgram const> D) : ExecState{ D, 0, nullptr, 0ULL } {}
     ExecState(Program const* P, int argc, char* argv[]) : ExecState{ P, argc, argv, 0ULL } {}
     ExecState(Program const* P, std::size_t memory_size_in_bytes) : ExecState{ P, 0, nullptr, memory_size_in_bytes } {}
     explicit ExecState(Program const* P) : ExecState{ P, 0, nullptr, 0ULL } {}
     ~ExecState();
 
     Program const& program() const { return *program_; }
+    DecodedProgram const& decoded_program() const { return *decoded_program_; }
     PointerModel* pointer_model() const { return pointer_model_; }
+    MemBlockAllocator* allocator() const { return allocator_.get(); }
     std::size_t memory_size_in_bytes() const { return memory_size_in_bytes_; }
     bool can_allocate(std::size_t const num_bytes) const
     { return memory_size_in_bytes() == 0ULL ? true : pointer_model()->num_allocated_bytes() + num_bytes <= memory_size_in_bytes(); }
@@ -102,24 +259,53 @@ struct ExecState final
 
     std::string  report(std::string const&  error_message_suffix = "") const;
 
+    // When true, the constants view the bytes in DecodedProgram::constant_bytes(),
+    // which are shared with other states and must not be written.
+    bool shares_constants() const { return shares_constants_; }
     std::vector<MemBlock> const& constant_segment() const { return constant_segment_; }
     std::vector<MemBlock> const& static_segment() const { return static_segment_; }
     std::vector<MemBlock> const& function_segment() const { return function_segment_; }
     std::unordered_map<MemPtr, std::uint32_t> const& functions_at_addresses() const { return functions_at_addresses_; }
-    std::vector<StackRecord> const& stack_segment() const { return stack_segment_; }
+
+    // A function called through a function pointer at a call site, see call_target().
+    struct CallTarget
+    {
+        MemPtr address{ nullptr };
+        std::uint32_t func_idx{ 0U };
+    };
+
+    // Returns the function at the address called by the current instruction, or nullptr,
+    // if there is no function at the address. The current instruction must be a CALL
+    // through a function pointer. Last few targets of each call site are cached, so
+    // the lookup in functions_at_addresses() is done only on a miss.
+    CallTarget const* call_target(MemPtr address);
+
+    StackSegment const& stack_segment() const { return stack_segment_; }
     StackRecord const& stack_top() const { return stack_segment_.back(); }
     InstrPointer const& ip() const { return stack_top().ip(); }
-    std::unordered_map<MemPtr, MemBlock> const& heap_segment() const { return heap_segment_; }
+    Heap const& heap_segment() const { return heap_segment_; }
 
     Function const& current_function() const { return *current_function_; }
     BasicBlock const& current_block() const { return *current_block_; }
     Instruction const& current_instruction() const { return *current_instruction_; }
-    std::vector<MemBlock const*> const& current_operands() const { return current_operands_; }
+    DecodedInstruction const& current_decoded_instruction() const { return *current_decoded_instruction_; }
+    Operands const& current_operands() const { return current_operands_; }
 
-    std::vector<StackRecord>& stack_segment() { return stack_segment_; }
+    StackSegment& stack_segment() { return stack_segment_; }
     StackRecord& stack_top() { return stack_segment_.back(); }
+
+    // Pushes a record for a call of the function to the stack. The record of a finished
+    // call of the function is reused, if there is any (see has_recycled_stack_record()).
+    void push_stack_record(Function const& F);
+    // Pops the top record from the stack and keeps it for the next call of its function.
+    // The records are recycled only when the memory size is not limited, so that the
+    // memory of the kept records never counts against the limit.
+    void pop_stack_record();
+    bool has_recycled_stack_record(std::uint32_t const func_idx) const
+    { return !recycled_stack_records_.empty() && !recycled_stack_records_[func_idx].empty(); }
+    void release_recycled_stack_records();
     std::size_t stack_exit_depth() const { return stack_exit_depth_; }
-    std::unordered_map<MemPtr, MemBlock>& heap_segment() { return heap_segment_; }
+    Heap& heap_segment() { return heap_segment_; }
 
     std::vector<std::uint32_t> const& atexit_stack() const { return atexit_stack_; }
     void push_atexit_function(std::uint32_t const func_index) { atexit_stack_.push_back(func_index); }
@@ -127,20 +313,53 @@ struct ExecState final
 
     void set_stack_exit_depth(std::size_t const size) { stack_exit_depth_ = size; }
 
+    // Writes the exit code block, argc and argv to the parameters of the entry function,
+    // whose record was just pushed to the stack (i.e., at the transition to Stage::EXECUTING).
+    void write_entry_function_parameters();
+    // Replaces the command line arguments. It can be called before the entry function
+    // starts: in Stage::INITIALIZING, or at the first instruction of the entry function
+    // (e.g., after restore() of a snapshot taken there); then also the parameters of the
+    // entry function are updated. So one state can run the program on many inputs.
+    void set_command_line(int argc, char* argv[]);
+
     bool set_stage(Stage type);
     bool set_termination(Termination type, std::string const& terminator, std::string const& message, Instruction const* instruction = nullptr);
     void set_exit_code(std::int32_t const c) { exit_code_.write(c); }
     void insert_warning(std::string const&  text) { warnings_.insert(text); }
 
     void update_current_values();
+    // A faster variant of update_current_values() for the case when the
+    // instruction pointer was only moved to the next instruction in the block.
+    void update_current_values_to_next_instruction();
 
     std::string current_location_message() const;
     std::string make_error_message(std::string const& text) const;
 
+    // A typical use is to take the snapshot once the static initializer has
+    // finished, i.e., at the transition to Stage::EXECUTING, and to restore it
+    // before each run of the program. Analyzers of the state must be created
+    // anew (or reset, see Sanitizer::reset()) after the restore. The constants
+    // shared with the decoded program (see shares_constants()) are neither saved
+    // nor restored: they are immutable by contract, and their pages are read-only
+    // (see DecodedProgram::constant_bytes()), so a write to them crashes.
+    Snapshot snapshot() const;
+    void restore(Snapshot const& snapshot);
+
 private:
 
+    template<typename Visitor>
+    void for_each_memory_block(Visitor&& visitor) const;
+
+    // Allocates argv_ and argv_c_strings_ for the passed arguments.
+    void allocate_command_line(int argc, char* argv[]);
+
+    void build_operand_table(StackRecord& record, DecodedFunction const& decoded_function) const;
+    void update_undecoded_operands();
+
+    std::shared_ptr<DecodedProgram const> decoded_program_;
     Program const* program_;
     PointerModel* pointer_model_;
+    std::unique_ptr<MemBlockAllocator> allocator_;
     std::size_t memory_size_in_bytes_;
 
     Stage stage_;
@@ -154,21 +373,42 @@ private:
     std::vector<MemBlock> argv_c_strings_;
     std::unordered_set<std::string> warnings_;
 
+    bool shares_constants_;
     std::vector<MemBlock> constant_segment_;
     std::vector<MemBlock> static_segment_;
     std::vector<MemBlock> function_segment_;
     std::unordered_map<MemPtr, std::uint32_t> functions_at_addresses_;
-    std::vector<StackRecord> stack_segment_;
-    std::unordered_map<MemPtr, MemBlock> heap_segment_;
+    StackSegment stack_segment_;
+    // For each function the records of its finished calls, see pop_stack_record().
+    std::vector<std::vector<StackRecord> > recycled_stack_records_;
+    Heap heap_segment_;
+
+    struct CallSiteCache
+    {
+        static constexpr std::size_t capacity{ 4ULL };
+        std::array<CallTarget, capacity> targets{};
+        std::uint32_t size{ 0U };
+        // The slot replaced on the next miss, when the cache is full.
+        std::uint32_t next{ 0U };
+    };
+    // For each call site, see DecodedInstruction::call_site. The cached addresses
+    // are addresses of functions, so they survive restore of a snapshot.
+    std::vector<CallSiteCache> call_site_caches_;
 
     std::size_t stack_exit_depth_;
 
     std::vector<std::uint32_t> atexit_stack_;
 
+    // For each function the operand table, see StackRecord::operand_table(), with
+    // STATIC, CONSTANT, and FUNCTION operands resolved. The remaining ones are nullptr.
+    std::vector<std::vector<MemBlock const*> > operand_templates_;
+
     Function const* current_function_;
     BasicBlock const* current_block_;
     Instruction const* current_instruction_;
-    std::vector<MemBlock const*> current_operands_;
+    DecodedInstruction const* current_decoded_instruction_;
+    Operands current_operands_;
+    std::vector<MemBlock const*> undecoded_operands_;
 }; 
 
 
@@ -10,6 +10,10 @@ struct ExternCodeCStd : public ExternCode
 {
     explicit ExternCodeCStd(ExecState* const state, Sanitizer* const sanitizer);
 
+    // Forgets the state kept between calls of the functions (of getopt), e.g.,
+    // after ExecState::restore().
+    void reset() { getopt_optind_ = 0; getopt_group_position_ = 0; }
+
 private:
     void register_math_functions();
     void register_string_functions();
@@ -34,6 +38,17 @@ private:
     void strncmp_impl();
     void getopt_impl();
     void getopt_long_impl();
+    // The host getopt keeps its state in globals. So the calls from all instances
+    // are serialized and each instance keeps its own 'optind' and the number of
+    // options already returned from a group of short options (like "-abc") in
+    // argv[optind]. When another instance called getopt in between, the host state
+    // is reinitialized, 'optind' is put back and the options of the group are
+    // skipped by repeating the calls.
+    void begin_getopt(int argc, char* const argv[], char const* opt_string);
+    void end_getopt(int result);
+
+    int getopt_optind_{ 0 };
+    int getopt_group_position_{ 0 };
 };
 
 
@@ -0,0 +1,95 @@
+#ifndef SALA_HEAP_HPP_INCLUDED
+#   define SALA_HEAP_HPP_INCLUDED
+
+#   include <sala/memblock.hpp>
+#   include <sala/memblock_allocator.hpp>
+#   include <sala/pointer_model.hpp>
+#   include <array>
+#   include <vector>
+#   include <unordered_set>
+#   include <cstdint>
+
+namespace sala {
+
+
+// The heap segment of an execution state. Small blocks are allocated from
+// size classes (powers of two) in chunks obtained from the backing allocator
+// and freed slots are reused. Each slot starts with a header holding the index of its block,
+// so the block of a pointer is found without any search. Larger blocks are
+// allocated directly by the backing allocator. The live blocks are stored densely, in no particular
+// order.
+struct Heap final
+{
+    using const_iterator = std::vector<MemBlock>::const_iterator;
+
+    Heap(PointerModel* pointer_model, MemBlockAllocator* backing);
+    ~Heap();
+    Heap(Heap const&) = delete;
+    Heap& operator=(Heap const&) = delete;
+
+    std::size_t size() const { return blocks_.size(); }
+    bool empty() const { return blocks_.empty(); }
+    const_iterator begin() const { return blocks_.begin(); }
+    const_iterator end() const { return blocks_.end(); }
+
+    // Returns the block starting at the passed address, or nullptr,
+    // if there is no such block in the heap.
+    MemBlock const* find(MemPtr ptr) const;
+
+    // Throws std::bad_alloc, if the memory cannot be allocated.
+    MemBlock const& allocate(std::size_t num_bytes);
+    // Returns false, if there is no block starting at the passed address.
+    bool release(MemPtr ptr);
+    void clear();
+    // Replaces the content of the heap by the passed blocks, which must have
+    // been allocated by this heap.
+    void assign(std::vector<MemBlock> const& blocks);
+
+private:
+
+    struct SlotHeader
+    {
+        std::size_t index;
+        SlotHeader* next_free;
+    };
+    static_assert(sizeof(SlotHeader) <= MemBlockAllocator::alignment);
+
+    struct Slots final : public MemBlockAllocator
+    {
+        static std::size_t constexpr header_bytes = MemBlockAllocator::alignment;
+        static std::size_t constexpr chunk_bytes = 64ULL * 1024ULL;
+        static std::size_t constexpr num_size_classes = 9ULL;
+
+        explicit Slots(MemBlockAllocator* backing);
+        ~Slots() override;
+
+        void* allocate(std::size_t num_bytes) override;
+        void deallocate(void* ptr, std::size_t num_bytes) override;
+
+        bool in_chunk(MemPtr ptr) const;
+
+    private:
+        static std::size_t size_class(std::size_t num_slot_bytes);
+        static std::size_t slot_bytes(std::size_t const size_class) { return 32ULL << size_class; }
+
+        MemBlockAllocator* backing_;
+        std::array<SlotHeader*, num_size_classes> free_slots_;
+        std::unordered_set<std::uintptr_t> chunks_;
+        std::array<std::uint8_t*, num_size_classes> cursors_;
+        std::array<std::uint8_t*, num_size_classes> ends_;
+    };
+
+    static std::size_t constexpr no_index = ~0ULL;
+
+    static SlotHeader* header_of(MemPtr const start) { return (SlotHeader*)(start - detail::memblock_bytes_offset - Slots::header_bytes); }
+
+    PointerModel* pointer_model_;
+    Slots slots_;
+    std::vector<MemBlock> blocks_;
+    std::unordered_set<MemPtr> large_blocks_;
+};
+
+
+}
+
+#endif
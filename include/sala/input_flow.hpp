@@ -85,6 +85,7 @@ private:
     void register_external_linux_functions();
 
 protected:
+    template<typename... Analyzers> friend struct InterpreterWith;
 
     void do_load() override;
     void do_store() override;
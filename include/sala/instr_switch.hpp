@@ -5,21 +5,94 @@
 #   include <sala/exec_state.hpp>
 #   include <vector>
 
+// Calls the passed macro X for the name of each handler of InstrSwitch, e.g., to
+// call the handlers of a derived class non-virtually (see InterpreterWith).
+#   define SALA_INSTR_SWITCH_FOR_EACH_HANDLER(X) \
+    X(do_nop) \
+    X(do_halt) \
+    X(do_address) X(do_load) X(do_store) \
+    X(do_copy_8) X(do_copy_16) X(do_copy_32) X(do_copy_64) X(do_copy) \
+    X(do_memcpy) X(do_memmove) X(do_memset) X(do_moveptr) \
+    X(do_alloca) X(do_stacksave) X(do_stackrestore) X(do_malloc) X(do_free) \
+    X(do_add_s8) X(do_add_s16) X(do_add_s32) X(do_add_s64) X(do_add_u8) X(do_add_u16) X(do_add_u32) \
+    X(do_add_u64) X(do_add_f32) X(do_add_f64) \
+    X(do_sub_s8) X(do_sub_s16) X(do_sub_s32) X(do_sub_s64) X(do_sub_u8) X(do_sub_u16) X(do_sub_u32) \
+    X(do_sub_u64) X(do_sub_f32) X(do_sub_f64) \
+    X(do_mul_s8) X(do_mul_s16) X(do_mul_s32) X(do_mul_s64) X(do_mul_u8) X(do_mul_u16) X(do_mul_u32) \
+    X(do_mul_u64) X(do_mul_f32) X(do_mul_f64) \
+    X(do_div_s8) X(do_div_s16) X(do_div_s32) X(do_div_s64) X(do_div_u8) X(do_div_u16) X(do_div_u32) \
+    X(do_div_u64) X(do_div_f32) X(do_div_f64) \
+    X(do_rem_s8) X(do_rem_s16) X(do_rem_s32) X(do_rem_s64) X(do_rem_u8) X(do_rem_u16) X(do_rem_u32) \
+    X(do_rem_u64) \
+    X(do_and_8) X(do_and_16) X(do_and_32) X(do_and_64) \
+    X(do_or_8) X(do_or_16) X(do_or_32) X(do_or_64) \
+    X(do_xor_8) X(do_xor_16) X(do_xor_32) X(do_xor_64) \
+    X(do_shl_8) X(do_shl_16) X(do_shl_32) X(do_shl_64) \
+    X(do_shr_s8) X(do_shr_s16) X(do_shr_s32) X(do_shr_s64) X(do_shr_u8) X(do_shr_u16) X(do_shr_u32) \
+    X(do_shr_u64) \
+    X(do_neg_f32) X(do_neg_f64) \
+    X(do_extend_s8_s16) X(do_extend_s8_s32) X(do_extend_s8_s64) X(do_extend_s16_s32) X(do_extend_s16_s64) \
+    X(do_extend_s32_s64) X(do_extend_u8_u16) X(do_extend_u8_u32) X(do_extend_u8_u64) X(do_extend_u16_u32) \
+    X(do_extend_u16_u64) X(do_extend_u32_u64) X(do_extend_f32_f64) \
+    X(do_truncate_u64_u32) X(do_truncate_u64_u16) X(do_truncate_u64_u8) X(do_truncate_u32_u16) \
+    X(do_truncate_u32_u8) X(do_truncate_u16_u8) X(do_truncate_f64_f32) \
+    X(do_f2i_f32_s8) X(do_f2i_f32_s16) X(do_f2i_f32_s32) X(do_f2i_f32_s64) X(do_f2i_f32_u8) X(do_f2i_f32_u16) \
+    X(do_f2i_f32_u32) X(do_f2i_f32_u64) X(do_f2i_f64_s8) X(do_f2i_f64_s16) X(do_f2i_f64_s32) X(do_f2i_f64_s64) \
+    X(do_f2i_f64_u8) X(do_f2i_f64_u16) X(do_f2i_f64_u32) X(do_f2i_f64_u64) \
+    X(do_i2f_s8_f32) X(do_i2f_s8_f64) X(do_i2f_s16_f32) X(do_i2f_s16_f64) X(do_i2f_s32_f32) X(do_i2f_s32_f64) \
+    X(do_i2f_s64_f32) X(do_i2f_s64_f64) X(do_i2f_u8_f32) X(do_i2f_u8_f64) X(do_i2f_u16_f32) X(do_i2f_u16_f64) \
+    X(do_i2f_u32_f32) X(do_i2f_u32_f64) X(do_i2f_u64_f32) X(do_i2f_u64_f64) \
+    X(do_p2i_8) X(do_p2i_16) X(do_p2i_32) X(do_p2i_64) \
+    X(do_i2p_8) X(do_i2p_16) X(do_i2p_32) X(do_i2p_64) \
+    X(do_less_s8) X(do_less_s16) X(do_less_s32) X(do_less_s64) X(do_less_u8) X(do_less_u16) X(do_less_u32) \
+    X(do_less_u64) X(do_less_f32) X(do_less_f64) X(do_less_w32) X(do_less_w64) \
+    X(do_less_equal_s8) X(do_less_equal_s16) X(do_less_equal_s32) X(do_less_equal_s64) X(do_less_equal_u8) \
+    X(do_less_equal_u16) X(do_less_equal_u32) X(do_less_equal_u64) X(do_less_equal_f32) X(do_less_equal_f64) \
+    X(do_less_equal_w32) X(do_less_equal_w64) \
+    X(do_greater_s8) X(do_greater_s16) X(do_greater_s32) X(do_greater_s64) X(do_greater_u8) X(do_greater_u16) \
+    X(do_greater_u32) X(do_greater_u64) X(do_greater_f32) X(do_greater_f64) X(do_greater_w32) \
+    X(do_greater_w64) \
+    X(do_greater_equal_s8) X(do_greater_equal_s16) X(do_greater_equal_s32) X(do_greater_equal_s64) \
+    X(do_greater_equal_u8) X(do_greater_equal_u16) X(do_greater_equal_u32) X(do_greater_equal_u64) \
+    X(do_greater_equal_f32) X(do_greater_equal_f64) X(do_greater_equal_w32) X(do_greater_equal_w64) \
+    X(do_equal_u8) X(do_equal_u16) X(do_equal_u32) X(do_equal_u64) X(do_equal_f32) X(do_equal_f64) \
+    X(do_equal_w32) X(do_equal_w64) \
+    X(do_unequal_u8) X(do_unequal_u16) X(do_unequal_u32) X(do_unequal_u64) X(do_unequal_f32) X(do_unequal_f64) \
+    X(do_unequal_w32) X(do_unequal_w64) \
+    X(do_isnan_w32) X(do_isnan_w64) \
+    X(do_va_start) X(do_va_end) X(do_va_arg) X(do_va_copy) \
+    X(do_jump) X(do_branch) X(do_call) X(do_ret)
+
 namespace sala {
 
 
+struct DecodedInstruction;
+
+
 struct InstrSwitch
 {
+    using Handler = void (InstrSwitch::*)();
+
     virtual ~InstrSwitch() {}
 
     virtual Instruction const& instruction() const = 0;
-    virtual std::vector<MemBlock const*> const& operands() const = 0;
+    virtual Operands const& operands() const = 0;
 
     // Return true iff one of the following methods were called:
     //      do_jump(), do_branch(), do_call(), do_ret()
     // Otherwise, returns false.
     bool do_instruction_switch();
 
+    // The same as above, but the method to call was already selected
+    // by the decoding of the instruction, see DecodedProgram.
+    bool do_instruction_switch(DecodedInstruction const& decoded);
+
+    // Returns the method do_instruction_switch() calls for the instruction
+    // whose first and last operands have the passed counts of bytes. Returns
+    // nullptr, if the instruction is not valid. 
+    static Handler decode(Instruction const& instruction, std::size_t front_count, std::size_t back_count);
+    static bool transfers_control(Instruction::Opcode opcode);
+
     virtual void do_nop() {}
 
     virtual void do_halt() {}
@@ -5,14 +5,31 @@
 #   include <sala/instr_switch.hpp>
 #   include <sala/extern_code.hpp>
 #   include <sala/analyzer.hpp>
+#   include <sala/jit.hpp>
+#   include <sala/aot.hpp>
 #   include <vector>
+#   include <memory>
 #   include <functional>
+#   include <atomic>
+#   include <cstring>
 
 namespace sala {
 
 
 struct Interpreter : public InstrSwitch
 {
+    // Limits of a run. Zero means no limit. The limits are checked only
+    // once per 'check_interval' instructions, so the run may exceed the time
+    // budget slightly. The limit of steps is always exact.
+    struct Budget
+    {
+        double max_seconds{ 0.0 };
+        std::uint64_t max_steps{ 0ULL };
+        // When the flag is set (e.g., by a watchdog thread), the run stops.
+        std::atomic<bool> const* stop_flag{ nullptr };
+        std::uint64_t check_interval{ 4096ULL };
+    };
+
     explicit Interpreter(ExecState* state, ExternCode* extern_code, std::vector<Analyzer*> const& analyzers = {});
 
     ExecState const& state() const { return *state_; }
@@ -22,25 +39,85 @@ struct Interpreter : public InstrSwitch
     Function const& function() const { return state().current_function(); }
     BasicBlock const& block() const { return state().current_block(); }
     Instruction const& instruction() const override { return state().current_instruction(); }
-    std::vector<MemBlock const*> const& operands() const override { return state().current_operands(); }
+    Operands const& operands() const override { return state().current_operands(); }
     InstrPointer const& ip() const { return state().stack_top().ip(); }
     InstrPointer& ip() { return state().stack_top().ip(); }
 
     ExternCode const& extern_code() const { return *extern_code_; }
     ExternCode& extern_code() { return *extern_code_; }
     std::vector<Analyzer*> const& analyzers() const { return analyzers_; }
+    // Analyzers interested in instructions of the passed opcode, see Analyzer::interests().
+    std::vector<Analyzer*> const& analyzers(Instruction::Opcode const opcode) const
+    { return analyzers_of_opcodes_[(std::size_t)opcode]; }
 
     std::uint64_t  num_steps() const { return num_steps_; }
 
     bool done() const { return state().stage() == ExecState::Stage::FINISHED; }
-    void step();
+    // Executes one instruction. Like all the run methods below, it goes through
+    // run_until(), so a derived interpreter (see InterpreterWith) processes all of them.
+    void step() { run_until(num_steps_ + 1ULL); }
 
     void run();
     void run(double max_seconds);
+    void run(Budget const& budget);
     void run(std::function<bool(std::string&)> const&  terminator);
 
+    // Executes at most the passed number of instructions and returns true, if
+    // the execution is done. The execution can be resumed by the next call.
+    bool run_slice(std::uint64_t max_num_steps);
+    // Finishes the execution with an error (e.g., when a budget managed by
+    // the caller of run_slice() was exhausted).
+    void terminate_run(std::string const& error_message);
+
+    // Enables compilation of basic blocks entered at least 'hot_threshold' times
+    // to native code (see Jit), if the platform supports it. The compiled blocks
+    // are used only in runs without analyzers.
+    void enable_jit(std::uint32_t hot_threshold = 1000U);
+    // Uses the blocks of the module compiled ahead of time for the program of the
+    // state. Like the blocks of Jit, they are used only in runs without analyzers.
+    // The module must be loaded for the program of the state; AotModule::load()
+    // checks the library against the program.
+    void enable_aot(std::shared_ptr<AotModule const> const& module);
+    Jit const* jit() const { return jit_.get(); }
+
+protected:
+
+    // Runs until the execution is done or num_steps() reaches the passed value.
+    virtual void run_until(std::uint64_t max_num_steps);
+    // Executes one instruction with the analyzers of analyzers().
+    void step_with_analyzers();
+
+    // The parts of step_with_analyzers(). The method begin_step() returns false, if
+    // the execution cannot continue. The method execute_instruction() executes
+    // the current instruction by the interpreter only. The method finish_step()
+    // handles the stack exit depth and moves to the next instruction.
+    bool begin_step();
+    void execute_instruction();
+    void finish_step();
+
 private:
 
+    // A variant of the handler of an instruction generated for the exact types of
+    // its operands. It gets the operands of the instruction explicitly.
+    using FastHandler = void (*)(MemBlock const* const* operands, DecodedInstruction const& decoded);
+
+    // Returns the variant of the handler of the decoded instruction for the types of
+    // its operands and for its last operand being an immediate value (see
+    // DecodedInstruction::immediate), or nullptr, if there is no such variant.
+    static FastHandler specialize(DecodedFunction const& function, DecodedInstruction const& decoded);
+    // Fills fast_handlers_ for the instructions of the program of the state.
+    void build_fast_handlers();
+
+    // Used by run_until() when there are no analyzers. It avoids the checks
+    // of step_with_analyzers() for all instructions not changing the stack.
+    void run_without_analyzers(std::uint64_t max_num_steps);
+    // Executes all instructions of the fused operation starting at the current instruction.
+    void do_fused(DecodedInstruction const& decoded);
+    // Runs compiled blocks from the start of the current block while they fit into
+    // the limit. Returns false, if the current block is not compiled. Each block
+    // entry is passed to Jit::enter() once (see jit_entry_counted_).
+    bool run_compiled_blocks(std::uint64_t max_num_steps);
+
     void do_halt() override;
 
     void do_address() override;
@@ -298,10 +375,48 @@ private:
     void do_call() override;
     void do_ret() override;
 
+    // The immediate value of the instruction, see DecodedInstruction::immediate.
+    template<typename T>
+    static T immediate(DecodedInstruction const& decoded)
+    {
+        T value;
+        std::memcpy(&value, &decoded.immediate, sizeof(T));
+        return value;
+    }
+
+    // The handlers selected by specialize(). They read the last operand from the
+    // immediate value, if 'Immediate' is true.
+    template<typename T, bool Immediate>
+    static void do_copy_fast(MemBlock const* const* const ops, DecodedInstruction const& decoded)
+    {
+        ops[0]->write<T>(Immediate ? immediate<T>(decoded) : ops[1]->read<T>());
+    }
+
+    template<typename T, typename Operation, bool Immediate>
+    static void do_arithmetic_fast(MemBlock const* const* const ops, DecodedInstruction const& decoded)
+    {
+        ops[0]->write<T>((T)Operation{}(ops[1]->read<T>(), Immediate ? immediate<T>(decoded) : ops[2]->read<T>()));
+    }
+
+    template<typename T, typename Comparison, bool Immediate>
+    static void do_compare_fast(MemBlock const* const* const ops, DecodedInstruction const& decoded)
+    {
+        ops[0]->write<std::uint8_t>((std::uint8_t)Comparison{}(ops[1]->read<T>(), Immediate ? immediate<T>(decoded) : ops[2]->read<T>()));
+    }
+
     ExecState* state_;
     ExternCode* extern_code_;
     std::vector<Analyzer*> analyzers_;
+    std::vector<std::vector<Analyzer*> > analyzers_of_opcodes_;
     std::uint64_t  num_steps_;
+    // For each instruction of the program (see DecodedInstruction::index) the result
+    // of specialize(). It is built by the first run without analyzers.
+    std::vector<FastHandler> fast_handlers_;
+    std::unique_ptr<Jit> jit_;
+    // True, if the entry to the current block was already passed to Jit::enter(),
+    // so that the next check of compiled blocks does not count it again.
+    bool jit_entry_counted_;
+    std::shared_ptr<AotModule const> aot_module_;
 };
 
 
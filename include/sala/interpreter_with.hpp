@@ -0,0 +1,123 @@
+#ifndef SALA_INTERPRETER_WITH_HPP_INCLUDED
+#   define SALA_INTERPRETER_WITH_HPP_INCLUDED
+
+#   include <sala/interpreter.hpp>
+#   include <sala/analyzer.hpp>
+#   include <sala/decoded_program.hpp>
+#   include <tuple>
+#   include <type_traits>
+#   include <typeinfo>
+#   include <utility>
+#   include <vector>
+
+namespace sala {
+
+
+// An interpreter with the list of analyzers fixed at compile time,
+// e.g., InterpreterWith<Sanitizer, InputFlow>. All methods running the
+// interpreter (step(), run(), run_slice(), ...) call the analyzers directly
+// via their static types, without iterating the vector of analyzers. The
+// handler of an instruction is called on an analyzer by a qualified name,
+// i.e., not virtually, so the handlers of the analyzers must be accessible
+// to InterpreterWith (e.g., it is a friend of the analyzer). An analyzer of
+// a type derived from the listed one is called virtually. All analyzers share
+// the decoding of instructions with the interpreter.
+template<typename... Analyzers>
+struct InterpreterWith final : public Interpreter
+{
+    static_assert((std::is_base_of_v<Analyzer, Analyzers> && ...));
+
+    InterpreterWith(ExecState* const state, ExternCode* const extern_code, Analyzers* const... analyzers)
+        : Interpreter{ state, extern_code, { static_cast<Analyzer*>(analyzers)... } }
+        , static_analyzers_{ analyzers... }
+        , hooks_{ make_hooks(analyzers)... }
+    {}
+
+    std::tuple<Analyzers*...> const& static_analyzers() const { return static_analyzers_; }
+
+protected:
+    void run_until(std::uint64_t const max_num_steps) override
+    {
+        if constexpr (sizeof...(Analyzers) == 0)
+            Interpreter::run_until(max_num_steps);
+        else
+            while (!done() && num_steps() < max_num_steps)
+                step_with_static_analyzers(std::index_sequence_for<Analyzers...>{});
+    }
+
+private:
+    // Calls the handler of an instruction on an analyzer of the exact type A.
+    template<typename A>
+    using Hook = void (*)(A&);
+
+    template<typename A>
+    static Hook<A> hook_of(InstrSwitch::Handler const handler)
+    {
+#   define SALA_INTERPRETER_WITH_HOOK(NAME) \
+        if (handler == &InstrSwitch::NAME) \
+            return [](A& analyzer) { analyzer.A::NAME(); };
+        SALA_INSTR_SWITCH_FOR_EACH_HANDLER(SALA_INTERPRETER_WITH_HOOK)
+#   undef SALA_INTERPRETER_WITH_HOOK
+        return nullptr;
+    }
+
+    // The hooks of the instructions of the program (see DecodedInstruction::index).
+    template<typename A>
+    std::vector<Hook<A> > make_hooks(A* const analyzer) const
+    {
+        std::vector<Hook<A> > hooks;
+        if (typeid(*analyzer) != typeid(A))
+            return hooks;
+        hooks.resize(state().decoded_program().num_instructions(), nullptr);
+        for (DecodedFunction const& function : state().decoded_program().functions())
+            for (DecodedInstruction const& decoded : function.instructions())
+                if (decoded.handler != nullptr)
+                    hooks[decoded.index] = hook_of<A>(decoded.handler);
+        return hooks;
+    }
+
+    template<std::size_t I>
+    bool pre(Instruction::Opcode const opcode, DecodedInstruction const& decoded)
+    {
+        auto* const analyzer{ std::get<I>(static_analyzers_) };
+        if (!analyzer->is_interested(opcode))
+            return true;
+        auto const& hooks{ std::get<I>(hooks_) };
+        analyzer->set_post_operation(nullptr);
+        if (!hooks.empty() && hooks[decoded.index] != nullptr)
+            hooks[decoded.index](*analyzer);
+        else
+            analyzer->do_instruction_switch(decoded);
+        return !done();
+    }
+
+    template<std::size_t... I>
+    void step_with_static_analyzers(std::index_sequence<I...>)
+    {
+        if (!begin_step())
+            return;
+
+        Instruction::Opcode const opcode{ instruction().opcode() };
+        DecodedInstruction const& decoded{ state().current_decoded_instruction() };
+
+        if (!(pre<I>(opcode, decoded) && ...))
+            return;
+
+        execute_instruction();
+
+        if (done())
+            return;
+
+        ((std::get<I>(static_analyzers_)->is_interested(opcode) ? std::get<I>(static_analyzers_)->post() : void()), ...);
+
+        finish_step();
+    }
+
+    std::tuple<Analyzers*...> static_analyzers_;
+    std::tuple<std::vector<Hook<Analyzers> >...> hooks_;
+};
+
+
+}
+
+#endif
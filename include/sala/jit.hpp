@@ -0,0 +1,78 @@
+#ifndef SALA_JIT_HPP_INCLUDED
+#   define SALA_JIT_HPP_INCLUDED
+
+#   include <sala/decoded_program.hpp>
+#   include <sala/memblock.hpp>
+#   include <vector>
+#   include <cstdint>
+
+namespace sala {
+
+
+// A baseline compiler of hot basic blocks to native code. It is available only on
+// x86-64 Linux, see is_supported(). A block is compiled after it was entered
+// 'hot_threshold' times, if it consists only of integer ADD, SUB, MUL, AND, OR,
+// XOR, COPY and comparisons of 4 or 8 bytes (and NOP), and ends with JUMP or BRANCH.
+// So the compiled code can never terminate the execution, call anything or change
+// the stack. It reads and writes the operands through the operand table of the
+// stack record (see StackRecord::operand_table()) and returns the index of the
+// successor block.
+//
+// An instance is owned by a single interpreter (see Interpreter::enable_jit()).
+struct Jit final
+{
+    using Code = std::uint32_t (*)(MemBlock const* const* operand_table);
+
+    struct Block
+    {
+        Code code{ nullptr };
+        std::uint32_t num_instructions{ 0U };
+        std::uint32_t num_entries{ 0U };
+        // True, if the block was already considered for the compilation.
+        bool visited{ false };
+    };
+
+    static bool is_supported();
+
+    Jit(DecodedProgram const* decoded_program, std::uint32_t hot_threshold);
+    ~Jit();
+    Jit(Jit const&) = delete;
+    Jit& operator=(Jit const&) = delete;
+
+    std::uint32_t hot_threshold() const { return hot_threshold_; }
+    void set_hot_threshold(std::uint32_t const hot_threshold) { hot_threshold_ = hot_threshold; }
+    std::size_t num_compiled_blocks() const { return num_compiled_blocks_; }
+
+    // Uses the passed code for the block, e.g., a block compiled ahead of time (see AotModule).
+    // The code must stay valid for the lifetime of the instance.
+    void add_native_block(std::uint32_t func_idx, std::uint32_t block_idx, Code code, std::uint32_t num_instructions);
+
+    // Called on each entry to the block. Returns the block, if it is compiled.
+    Block const* enter(std::uint32_t const func_idx, std::uint32_t const block_idx)
+    {
+        Block& block{ blocks_[func_idx][block_idx] };
+        if (block.code != nullptr)
+            return &block;
+        if (block.visited || ++block.num_entries < hot_threshold_)
+            return nullptr;
+        return compile(func_idx, block_idx);
+    }
+
+private:
+    Block const* compile(std::uint32_t func_idx, std::uint32_t block_idx);
+    // Copies the code to an executable memory and returns its start.
+    Code install(std::vector<std::uint8_t> const& code);
+
+    DecodedProgram const* decoded_program_;
+    std::uint32_t hot_threshold_;
+    std::vector<std::vector<Block> > blocks_;
+    std::size_t num_compiled_blocks_;
+    // Pages of the executable memory, the last one is being filled.
+    std::vector<std::pair<std::uint8_t*, std::size_t> > pages_;
+    std::size_t page_cursor_;
+};
+
+
+}
+
+#endif
@@ -2,18 +2,34 @@
 #   define SALA_MEMBLOCK_HPP_INCLUDED
 
 #   include <sala/pointer_model.hpp>
+#   include <sala/memblock_allocator.hpp>
 #   include <vector>
 #   include <unordered_map>
 #   include <memory>
+#   include <cstddef>
 #   include <cstdint>
 
 namespace sala::detail {
 
 
+struct MemBlockSlab;
+
+
+// The data of a memory block together with an intrusive reference counter.
+// The counter is not atomic, i.e., a block must not be shared by threads.
 struct MemBlockData final
 {
-    MemBlockData(PointerModel* pointer_model, std::size_t num_bytes, std::uint8_t init_value);
+    // Creates a block in a single allocation (the data followed by the bytes).
+    static MemBlockData* create(MemBlockAllocator* allocator, PointerModel* pointer_model, std::size_t num_bytes);
+
+    MemBlockData(PointerModel* pointer_model, MemPtr bytes_ptr, std::size_t num_bytes, MemBlockAllocator* allocator, MemBlockSlab* slab);
     ~MemBlockData();
+    MemBlockData(MemBlockData const&) = delete;
+    MemBlockData& operator=(MemBlockData const&) = delete;
+
+    void acquire() { ++ref_count_; }
+    void release() { if (--ref_count_ == 0ULL) destroy(); }
+
     PointerModel* pointer_model() const { return pointer_model_; }
     MemPtr start() const { return bytes; }
     std::size_t count() const { return count_; }
@@ -29,13 +45,28 @@ struct MemBlockData final
     void write_pointer_as_uint16(MemPtr const ptr) const { pointer_model()->write_pointer_as_uint16(start(), ptr); }
     void write_pointer_as_uint32(MemPtr const ptr) const { pointer_model()->write_pointer_as_uint32(start(), ptr); }
     void write_pointer_as_uint64(MemPtr const ptr) const { pointer_model()->write_pointer_as_uint64(start(), ptr); }
+
+    // The offset of the pointer returned by start(), for the native code of Jit.
+    static std::size_t start_member_offset() { return offsetof(MemBlockData, bytes); }
 private:
+    void destroy();
+
     PointerModel* pointer_model_;
     std::uint8_t* bytes;
     std::size_t count_;
+    std::size_t ref_count_;
+    MemBlockAllocator* allocator_;
+    MemBlockSlab* slab_;
 };
 
 
+// The offset of the bytes of a block from the start of the memory of the block
+// created by MemBlockData::create().
+inline constexpr std::size_t memblock_bytes_offset{
+    (sizeof(MemBlockData) + MemBlockAllocator::alignment - 1ULL) & ~(MemBlockAllocator::alignment - 1ULL)
+    };
+
+
 template<typename T>
 struct MemBlockDataReader
 { static inline T read(MemBlockData* const data) { return *(T*)data->start(); } };
@@ -69,8 +100,55 @@ namespace sala {
 
 struct MemBlock final
 {
-    MemBlock();
+    MemBlock() : data_{ nullptr } {}
     MemBlock(PointerModel* pointer_model, std::size_t num_bytes, std::uint8_t init_value = 0xcd);
+    MemBlock(MemBlockAllocator* allocator, PointerModel* pointer_model, std::size_t num_bytes, std::uint8_t init_value = 0xcd);
+    MemBlock(MemBlock const& other) : data_{ other.data_ } { if (data_ != nullptr) data_->acquire(); }
+    MemBlock(MemBlock&& other) noexcept : data_{ other.data_ } { other.data_ = nullptr; }
+    ~MemBlock() { reset(); }
+
+    MemBlock& operator=(MemBlock const& other)
+    {
+        if (other.data_ != nullptr)
+            other.data_->acquire();
+        reset();
+        data_ = other.data_;
+        return *this;
+    }
+
+    MemBlock& operator=(MemBlock&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            data_ = other.data_;
+            other.data_ = nullptr;
+        }
+        return *this;
+    }
+
+    // Creates memory blocks of the passed sizes inside a single contiguous slab
+    // of memory and appends them to 'blocks'. Each block starts at an offset aligned
+    // according to its size (up to 16 bytes) and it is followed by at least one byte
+    // not belonging to any block. The slab is released together with the last of the
+    // created blocks.
+    static void push_back_slab(
+        MemBlockAllocator* allocator,
+        PointerModel* pointer_model,
+        std::vector<std::size_t> const& sizes,
+        std::vector<MemBlock>& blocks,
+        std::uint8_t init_value = 0xcd
+        );
+
+    // Creates memory blocks of the passed starts and sizes over memory owned by
+    // somebody else, which must outlive the blocks, and appends them to 'blocks'.
+    // Only the data of the blocks is allocated (in a single slab).
+    static void push_back_views(
+        MemBlockAllocator* allocator,
+        PointerModel* pointer_model,
+        std::vector<std::pair<MemPtr, std::size_t> > const& ranges,
+        std::vector<MemBlock>& blocks
+        );
 
     MemPtr start() const { return data_->start(); }
     std::size_t count() const { return data_->count(); }
@@ -79,10 +157,10 @@ struct MemBlock final
     std::int64_t as_shift() const;
 
     template<typename T>
-    T read() const { return detail::MemBlockDataReader<T>::read(data_.get()); }
+    T read() const { return detail::MemBlockDataReader<T>::read(data_); }
 
     template<typename T>
-    void write(T const value) const { detail::MemBlockDataWriter<T>::write(data_.get(), value); }
+    void write(T const value) const { detail::MemBlockDataWriter<T>::write(data_, value); }
     void write_pointer_from_offset(std::size_t const offset, MemPtr const ptr) const { data_->write_pointer_from_offset(offset, ptr); }
 
     void write_shifted(MemPtr const from, std::int64_t const shift) const { data_->read_shift_and_write_pointer(from, shift); }
@@ -97,11 +175,17 @@ struct MemBlock final
 
     PointerModel const* pointer_model() const { return data_->pointer_model(); }
 
+    // The offset of the pointer to the data of the block, for the native code of Jit.
+    static std::size_t data_member_offset() { return offsetof(MemBlock, data_); }
+
 private:
 
-    std::shared_ptr<detail::MemBlockData> data_;
-};
+    explicit MemBlock(detail::MemBlockData* const data) : data_{ data } {}
+
+    void reset() { if (data_ != nullptr) { data_->release(); data_ = nullptr; } }
 
+    detail::MemBlockData* data_;
+};
 
 }
 
@@ -0,0 +1,197 @@
+#ifndef SALA_MEMBLOCK_ALLOCATOR_HPP_INCLUDED
+#   define SALA_MEMBLOCK_ALLOCATOR_HPP_INCLUDED
+
+#   include <array>
+#   include <vector>
+#   include <unordered_map>
+#   include <memory>
+#   include <atomic>
+#   include <cstdint>
+#   include <cstddef>
+
+namespace sala {
+
+
+// A source of memory for memory blocks (see MemBlock). All returned
+// addresses are aligned to 'alignment' bytes. An allocator must outlive
+// all memory blocks allocated from it.
+struct MemBlockAllocator
+{
+    static std::size_t constexpr alignment = 16ULL;
+
+    virtual ~MemBlockAllocator() {}
+
+    virtual void* allocate(std::size_t num_bytes) = 0;
+    virtual void deallocate(void* ptr, std::size_t num_bytes) = 0;
+
+    // Returns memory aligned to 'num_bytes', which must be a power of two.
+    // The default implementation uses the global operator new and delete.
+    virtual void* allocate_chunk(std::size_t num_bytes);
+    virtual void deallocate_chunk(void* ptr, std::size_t num_bytes);
+
+    // The process-wide allocator using the global operator new and delete.
+    static MemBlockAllocator* heap();
+};
+
+
+struct MemBlockAllocatorHeap final : public MemBlockAllocator
+{
+    void* allocate(std::size_t num_bytes) override;
+    void deallocate(void* ptr, std::size_t num_bytes) override;
+};
+
+
+// Serves requests up to 'max_pooled_bytes' from free lists of size classes
+// (powers of two), which are refilled from large chunks. Freed memory is
+// reused for later requests of the same size class. Larger requests go to
+// the global operator new.
+struct MemBlockAllocatorPools final : public MemBlockAllocator
+{
+    static std::size_t constexpr max_pooled_bytes = 4096ULL;
+    static std::size_t constexpr chunk_bytes = 64ULL * 1024ULL;
+
+    MemBlockAllocatorPools();
+    ~MemBlockAllocatorPools() override;
+
+    void* allocate(std::size_t num_bytes) override;
+    void deallocate(void* ptr, std::size_t num_bytes) override;
+
+private:
+    static std::size_t size_class(std::size_t num_bytes);
+
+    struct FreeNode { FreeNode* next; };
+
+    std::array<FreeNode*, 9ULL> free_lists_;
+    std::vector<void*> chunks_;
+    std::uint8_t* chunk_cursor_;
+    std::uint8_t* chunk_end_;
+};
+
+
+// Bump allocation in large chunks. Deallocation does nothing, all memory
+// is released at once together with the arena. It suits short executions
+// creating many short-lived blocks.
+struct MemBlockAllocatorArena final : public MemBlockAllocator
+{
+    static std::size_t constexpr chunk_bytes = 256ULL * 1024ULL;
+
+    MemBlockAllocatorArena();
+    ~MemBlockAllocatorArena() override;
+
+    void* allocate(std::size_t num_bytes) override;
+    void deallocate(void*, std::size_t) override {}
+
+    std::size_t num_reserved_bytes() const { return num_reserved_bytes_; }
+
+private:
+    std::vector<void*> chunks_;
+    std::uint8_t* chunk_cursor_;
+    std::uint8_t* chunk_end_;
+    std::size_t num_reserved_bytes_;
+};
+
+
+// All memory is sub-allocated from one contiguous region of address space
+// reserved up front (by mmap, or VirtualAlloc on Windows). Physical pages are
+// provided by the system on the first access. Requests up to
+// 'max_pooled_bytes' are served from free lists of size classes, larger ones
+// are rounded up to whole pages and reused only for requests of the same
+// rounded size. The first page of the region is never used, so no address
+// has the offset 0 from the base; with the default size of the region (one page
+// less than 4GB) all offsets, including the one of the end of the region, fit
+// to 32 bits (see PointerModelM32_FlatOffset).
+// Throws std::bad_alloc, when the region is exhausted.
+struct MemBlockAllocatorFlat final : public MemBlockAllocator
+{
+    static std::size_t constexpr page_bytes = 4096ULL;
+    static std::size_t constexpr default_region_bytes = (1ULL << 32U) - page_bytes;
+    static std::size_t constexpr max_pooled_bytes = 4096ULL;
+
+    // The tracking of writes (see track_writes()) must be enabled explicitly.
+    explicit MemBlockAllocatorFlat(std::size_t num_region_bytes = default_region_bytes, bool enable_write_tracking = false);
+    ~MemBlockAllocatorFlat() override;
+    MemBlockAllocatorFlat(MemBlockAllocatorFlat const&) = delete;
+    MemBlockAllocatorFlat& operator=(MemBlockAllocatorFlat const&) = delete;
+
+    void* allocate(std::size_t num_bytes) override;
+    void deallocate(void* ptr, std::size_t num_bytes) override;
+    void* allocate_chunk(std::size_t num_bytes) override;
+    void deallocate_chunk(void* ptr, std::size_t num_bytes) override;
+
+    std::uint8_t* begin() const { return begin_; }
+    std::uint8_t* end() const { return end_; }
+    // The end of the part of the region used so far.
+    std::uint8_t* cursor() const { return cursor_; }
+    bool contains(void const* const ptr) const { return begin_ <= (std::uint8_t const*)ptr && (std::uint8_t const*)ptr < end_; }
+
+    // Tracking of writes, supported on Linux only and only when it was enabled in
+    // the constructor. The call track_writes() write-protects the part of the region
+    // used so far and starts a new epoch. The first write to a protected page makes
+    // the page writable again and records it as dirty. The call protect_dirty_pages()
+    // write-protects the dirty pages again and forgets them. Returns false, if the
+    // tracking is not enabled or not supported; ExecState::snapshot() then copies
+    // the whole memory back on restore.
+    //
+    // The write faults are caught by a process-wide handler of SIGSEGV, which the
+    // first call of track_writes() in the process installs by sigaction() and which
+    // is never removed. The handler passes the faults outside of tracked regions to
+    // the handler installed before it (or to the default action). So an application
+    // with its own SIGSEGV handler must install it before the tracking starts, or
+    // chain to the previous handler; otherwise the tracked pages stay write-protected
+    // and the writes of the interpreted program crash. No handler is installed, if
+    // the tracking is not enabled for any allocator.
+    bool write_tracking_enabled() const { return write_tracking_enabled_; }
+    bool track_writes();
+    void protect_dirty_pages();
+    bool tracks_writes() const { return tracked_end_ != nullptr; }
+    std::uint64_t tracking_epoch() const { return tracking_epoch_; }
+    std::uint8_t* tracked_end() const { return tracked_end_; }
+    std::size_t tracking_page_bytes() const { return tracking_page_bytes_; }
+    std::size_t num_dirty_pages() const { return num_dirty_pages_; }
+    std::uint8_t* dirty_page(std::size_t const i) const { return begin_ + dirty_pages_[i] * tracking_page_bytes_; }
+
+private:
+    static std::size_t size_class(std::size_t num_bytes);
+
+    // Called from the handler of write faults; returns false, if the address
+    // does not belong to a tracked region.
+    static bool on_write_fault(void* address);
+
+    // A registered allocator tracking writes. The handler of write faults counts
+    // itself in 'num_users' before it reads the allocator, and the destructor of
+    // the allocator clears the slot and waits for the count to drop to zero before
+    // it unmaps the region.
+    struct TrackingSlot
+    {
+        std::atomic<MemBlockAllocatorFlat*> allocator{ nullptr };
+        std::atomic<std::uint32_t> num_users{ 0U };
+    };
+    static_assert(std::atomic<MemBlockAllocatorFlat*>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free,
+                  "The tracking slots are accessed from a signal handler.");
+
+    static std::size_t constexpr max_tracking_allocators = 64ULL;
+    static std::array<TrackingSlot, max_tracking_allocators> tracking_slots_;
+
+    std::uint8_t* bump(std::size_t num_bytes, std::size_t alignment);
+
+    struct FreeNode { FreeNode* next; };
+
+    std::uint8_t* begin_;
+    std::uint8_t* end_;
+    std::uint8_t* cursor_;
+    std::uint8_t* committed_end_;
+    std::array<FreeNode*, 9ULL> free_lists_;
+    std::unordered_map<std::size_t, std::vector<void*> > free_pages_;
+    std::unordered_map<std::size_t, std::vector<void*> > free_chunks_;
+    bool write_tracking_enabled_;
+    std::uint8_t* tracked_end_;
+    std::uint64_t tracking_epoch_;
+    std::size_t tracking_page_bytes_;
+    std::unique_ptr<std::size_t[]> dirty_pages_;
+    std::atomic<std::size_t> num_dirty_pages_;
+};
+
+
+}
+
+#endif
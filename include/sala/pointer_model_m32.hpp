@@ -102,6 +102,41 @@ private:
 };
 
 
+
+// Pointers are 32-bit offsets from the start of a contiguous region of
+// memory of less than 4GB containing all memory blocks (see MemBlockAllocatorFlat).
+// The offset 0 represents nullptr. Addresses outside the region (except its end)
+// are written as nullptr.
+struct PointerModelM32_FlatOffset : public PointerModel
+{
+    PointerModelM32_FlatOffset(MemPtr region_begin, MemPtr region_end);
+
+    std::size_t sizeof_pointer() override;
+    void on_memblock_allocated(MemPtr) override {}
+    void on_memblock_released(MemPtr) override {}
+    MemPtr read_pointer(MemPtr from) override;
+    void write_pointer(MemPtr to, MemPtr ptr) override;
+    void read_shift_and_write(MemPtr to, MemPtr from, std::int64_t shift) override;
+    void write_uint8_as_pointer(MemPtr to, std::uint8_t int_ptr) override;
+    void write_uint16_as_pointer(MemPtr to, std::uint16_t int_ptr) override;
+    void write_uint32_as_pointer(MemPtr to, std::uint32_t int_ptr) override;
+    void write_uint64_as_pointer(MemPtr to, std::uint64_t int_ptr) override;
+    void write_pointer_as_uint8(MemPtr to, MemPtr ptr) override;
+    void write_pointer_as_uint16(MemPtr to, MemPtr ptr) override;
+    void write_pointer_as_uint32(MemPtr to, MemPtr ptr) override;
+    void write_pointer_as_uint64(MemPtr to, MemPtr ptr) override;
+
+private:
+
+    using MemPtr32bit = std::uint32_t;
+    static MemPtr32bit constexpr nullptr_32bit = 0U;
+
+    MemPtr32bit to_offset(MemPtr ptr) const;
+
+    MemPtr region_begin_;
+    MemPtr region_end_;
+};
+
 }
 
 #endif
@@ -33,10 +33,13 @@ struct Constant
     std::size_t num_bytes() const { return bytes().size(); }
     std::vector<std::uint8_t> const& bytes() const { return bytes_; }
 
-    void set_program(Program* const program) { program_ = program; }
-    void set_index(std::uint32_t const index) { index_ = index; }
-    void push_back_byte(std::uint8_t const byte) { bytes_.push_back(byte); }
+    void set_program(Program* const program) { assume_not_frozen(); program_ = program; }
+    void set_index(std::uint32_t const index) { assume_not_frozen(); index_ = index; }
+    void push_back_byte(std::uint8_t const byte) { assume_not_frozen(); bytes_.push_back(byte); }
 private:
+    // The mutators must not be called, once the program is frozen (see Program::freeze()).
+    void assume_not_frozen() const;
+
     Program* program_{ nullptr };
     std::uint32_t index_{};
     std::vector<std::uint8_t> bytes_{};
@@ -59,14 +62,16 @@ struct Variable
     bool is_external() const { return is_external_; }
     SourceBackMapping const& source_back_mapping() const { return back_mapping_; }
 
-    void set_program(Program* const program) { program_ = program; }
-    void set_function_index(std::uint32_t const index) { function_index_ = index; }
-    void set_index(std::uint32_t const index) { index_ = index; }
-    void set_region(Region region) { region_ = region; }
-    void set_num_bytes(std::size_t const num_bytes) { num_bytes_ = num_bytes; }
-    void set_external(bool const state) { is_external_ = state; }
-    SourceBackMapping& source_back_mapping() { return back_mapping_; }
+    void set_program(Program* const program) { assume_not_frozen(); program_ = program; }
+    void set_function_index(std::uint32_t const index) { assume_not_frozen(); function_index_ = index; }
+    void set_index(std::uint32_t const index) { assume_not_frozen(); index_ = index; }
+    void set_region(Region region) { assume_not_frozen(); region_ = region; }
+    void set_num_bytes(std::size_t const num_bytes) { assume_not_frozen(); num_bytes_ = num_bytes; }
+    void set_external(bool const state) { assume_not_frozen(); is_external_ = state; }
+    SourceBackMapping& source_back_mapping() { assume_not_frozen(); return back_mapping_; }
 private:
+    void assume_not_frozen() const;
+
     Program* program_{ nullptr };
     std::uint32_t function_index_{ 0U };
     std::uint32_t index_{};
@@ -602,6 +607,7 @@ struct Instruction
         FUNCTION,
     };
 
+    Program* program() const { return program_; }
     std::uint32_t basic_block_index() const { return basic_block_index_; }
     std::uint32_t index() const { return index_; }
     Opcode opcode() const { return opcode_; }
@@ -610,14 +616,18 @@ struct Instruction
     std::vector<Descriptor> const& descriptors() const { return descriptors_; }
     SourceBackMapping const& source_back_mapping() const { return back_mapping_; }
 
-    void set_basic_block_index(std::uint32_t const index) { basic_block_index_ = index; }
-    void set_index(std::uint32_t const index) { index_ = index; }
-    void set_opcode(Opcode const op) { opcode_ = op; }
-    void set_modifier(Modifier const modifier) { modifier_ = modifier; }
+    void set_program(Program* const program) { assume_not_frozen(); program_ = program; }
+    void set_basic_block_index(std::uint32_t const index) { assume_not_frozen(); basic_block_index_ = index; }
+    void set_index(std::uint32_t const index) { assume_not_frozen(); index_ = index; }
+    void set_opcode(Opcode const op) { assume_not_frozen(); opcode_ = op; }
+    void set_modifier(Modifier const modifier) { assume_not_frozen(); modifier_ = modifier; }
     void push_back_operand(std::uint32_t const operand, Descriptor const descriptor);
     void assign(Instruction const& other);
-    SourceBackMapping& source_back_mapping() { return back_mapping_; }
+    SourceBackMapping& source_back_mapping() { assume_not_frozen(); return back_mapping_; }
 private:
+    void assume_not_frozen() const;
+
+    Program* program_{ nullptr };
     std::uint32_t basic_block_index_{ 0U };
     std::uint32_t index_{ 0U };
     Opcode opcode_{ Opcode::__INVALID__ };
@@ -630,22 +640,27 @@ private:
 
 struct BasicBlock
 {
+    Program* program() const { return program_; }
     std::uint32_t function_index() const { return function_index_; }
     std::uint32_t index() const { return index_; }
     std::vector<Instruction> const& instructions() const { return instructions_; }
     std::vector<std::uint32_t> const& successors() const { return successors_; }
 
-    void set_function_index(std::uint32_t const index) { function_index_ = index; }
-    void set_index(std::uint32_t const index) { index_ = index; }
+    void set_program(Program* const program) { assume_not_frozen(); program_ = program; }
+    void set_function_index(std::uint32_t const index) { assume_not_frozen(); function_index_ = index; }
+    void set_index(std::uint32_t const index) { assume_not_frozen(); index_ = index; }
     Instruction& push_back_instruction();
-    void push_back_successor(std::uint32_t const succ_index) { successors_.push_back(succ_index); }
+    void push_back_successor(std::uint32_t const succ_index) { assume_not_frozen(); successors_.push_back(succ_index); }
     void pop_back_instruction();
     void assign_instruction(std::size_t index, Instruction const& instruction);
-    Instruction& instruction_ref(std::uint32_t const idx) { return instructions_.at(idx); }
-    Instruction& last_instruction_ref() { return instructions_.back(); }
-    std::uint32_t& successor_ref(std::uint32_t const idx) { return successors_.at(idx); }
+    Instruction& instruction_ref(std::uint32_t const idx) { assume_not_frozen(); return instructions_.at(idx); }
+    Instruction& last_instruction_ref() { assume_not_frozen(); return instructions_.back(); }
+    std::uint32_t& successor_ref(std::uint32_t const idx) { assume_not_frozen(); return successors_.at(idx); }
 
 private:
+    void assume_not_frozen() const;
+
+    Program* program_{ nullptr };
     std::uint32_t function_index_{ 0U };
     std::uint32_t index_{ 0U };
     std::vector<Instruction> instructions_{};
@@ -662,21 +677,28 @@ struct Function
     std::vector<Variable> const& parameters() const { return parameters_; }
     std::vector<Variable> const& local_variables() const { return locals_; }
     bool is_external() const { return is_external_; }
+    // The sum of sizes of parameters and locals. It is precomputed by Program::freeze().
+    // The interpreter uses the value cached by DecodedFunction::initial_stack_bytes().
     std::size_t initial_stack_bytes() const;
     SourceBackMapping const& source_back_mapping() const { return back_mapping_; }
 
-    void set_program(Program* const program) { program_ = program; }
-    void set_name(std::string const& name) { name_ = name; }
-    void set_index(std::uint32_t const index) { index_ = index; }
-    void set_external(bool const state) { is_external_ = state; }
-    BasicBlock& basic_block_ref(std::uint32_t const idx) { return blocks_.at(idx); }
+    void set_program(Program* const program) { assume_not_frozen(); program_ = program; }
+    void set_name(std::string const& name) { assume_not_frozen(); name_ = name; }
+    void set_index(std::uint32_t const index) { assume_not_frozen(); index_ = index; }
+    void set_external(bool const state) { assume_not_frozen(); is_external_ = state; }
+    BasicBlock& basic_block_ref(std::uint32_t const idx) { assume_not_frozen(); return blocks_.at(idx); }
     BasicBlock& push_back_basic_block();
-    BasicBlock& last_basic_block_ref() { return blocks_.back(); }
+    BasicBlock& last_basic_block_ref() { assume_not_frozen(); return blocks_.back(); }
     Variable& push_back_parameter();
     Variable& push_back_local_variable();
-    Variable& last_local_variable_ref() { return locals_.back(); }
-    SourceBackMapping& source_back_mapping() { return back_mapping_; }
+    Variable& last_local_variable_ref() { assume_not_frozen(); return locals_.back(); }
+    SourceBackMapping& source_back_mapping() { assume_not_frozen(); return back_mapping_; }
 private:
+    friend struct Program;
+    // Called by Program::freeze().
+    void freeze();
+    void assume_not_frozen() const;
+
     Program* program_{ nullptr };
     std::string name_{};
     std::uint32_t index_{ 0U };
@@ -684,7 +706,7 @@ private:
     std::vector<Variable> parameters_{};
     std::vector<Variable> locals_{};
     bool is_external_{ false };
-    mutable std::size_t initial_stack_bytes_{ std::numeric_limits<std::size_t>::max() };
+    std::size_t initial_stack_bytes_{ std::numeric_limits<std::size_t>::max() };
     SourceBackMapping back_mapping_{};
 };
 
@@ -707,20 +729,29 @@ struct Program
     static std::uint32_t static_initializer();
     static std::string static_initializer_name();
 
-    void set_system(std::string const& system) { system_ = system; }
-    void set_num_cpu_bits(std::uint16_t const num_bits) { num_cpu_bits_ = num_bits; }
-    void set_name(std::string const& name) { name_ = name; }
-    void set_entry_function(std::uint32_t const index) { entry_function_ = index; }
-    Function& function_ref(std::uint32_t const index) { return functions_.at(index); }
-    Variable& static_variable_ref(std::uint32_t const index) { return variables_.at(index); }
+    // Precomputes all data derived from the program. A frozen program must not be
+    // modified: all mutators of the program and of its functions, basic blocks,
+    // instructions, variables and constants then fail on an assumption. All const
+    // methods of a frozen program are safe to call from multiple threads.
+    void freeze();
+    bool is_frozen() const { return frozen_; }
+
+    void set_system(std::string const& system) { assume_not_frozen(); system_ = system; }
+    void set_num_cpu_bits(std::uint16_t const num_bits) { assume_not_frozen(); num_cpu_bits_ = num_bits; }
+    void set_name(std::string const& name) { assume_not_frozen(); name_ = name; }
+    void set_entry_function(std::uint32_t const index) { assume_not_frozen(); entry_function_ = index; }
+    Function& function_ref(std::uint32_t const index) { assume_not_frozen(); return functions_.at(index); }
+    Variable& static_variable_ref(std::uint32_t const index) { assume_not_frozen(); return variables_.at(index); }
     Function& push_back_function(std::string const& func_name);
     Variable& push_back_static_variable();
     Constant& push_back_constant();
-    Constant& constant_ref(std::uint32_t const index) { return constants_.at(index); }
+    Constant& constant_ref(std::uint32_t const index) { assume_not_frozen(); return constants_.at(index); }
     void push_back_external_variable(std::uint32_t const index, std::string const& name);
     void push_back_external_function(std::uint32_t const index);
 
 private:
+    void assume_not_frozen() const;
+
     std::string version_;
     std::string system_;
     std::uint16_t num_cpu_bits_;
@@ -731,6 +762,7 @@ private:
     std::vector<Constant> constants_;
     std::vector<std::pair<std::uint32_t, std::string> > external_variables_;
     std::vector<std::uint32_t> external_functions_;
+    bool frozen_;
 };
 
 
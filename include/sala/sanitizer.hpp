@@ -3,6 +3,7 @@
 
 #   include <sala/analyzer.hpp>
 #   include <map>
+#   include <vector>
 
 namespace sala {
 
@@ -19,8 +20,17 @@ struct Sanitizer : public Analyzer
     bool is_c_string_valid(MemPtr str) const;
     bool is_c_string_valid(MemPtr str, std::size_t max_len) const;
 
+    // Forgets all memory regions and registers the memory of the state anew, e.g.,
+    // after ExecState::restore(). The checked call signatures are kept.
+    void reset();
+
 private:
+    template<typename... Analyzers> friend struct InterpreterWith;
+
     mutable MemRegionsMap regions_;
+    // For each call site through a function pointer (see DecodedInstruction::call_site)
+    // the indices of called functions whose parameters were already checked.
+    std::vector<std::vector<std::uint32_t> > checked_call_targets_;
 
     void insert(MemPtr ptr, std::size_t count);
     void erase(MemPtr const ptr, std::size_t count);
@@ -0,0 +1,75 @@
+#ifndef SALA_SCHEDULER_HPP_INCLUDED
+#   define SALA_SCHEDULER_HPP_INCLUDED
+
+#   include <sala/interpreter.hpp>
+#   include <condition_variable>
+#   include <deque>
+#   include <functional>
+#   include <mutex>
+#   include <cstdint>
+
+namespace sala {
+
+
+// Time-slices many interpreters over a small pool of worker threads. The ready
+// interpreters wait in a single FIFO queue. A worker takes the first one, runs
+// it for one slice (see Interpreter::run_slice()) and, unless it is done, puts
+// it at the end of the queue. So each interpreter gets the same number of
+// instructions per round and it is never run by two workers at once.
+//
+// The budget of an interpreter limits the instructions executed since it was
+// added and the time it actually ran in its slices. The check interval of the
+// budget is not used, the budgets are checked after each slice.
+struct Scheduler final
+{
+    using Id = std::size_t;
+    // Called by a worker when an interpreter is done, outside of any lock, so
+    // it may add new interpreters.
+    using Callback = std::function<void(Id, Interpreter&)>;
+
+    // Zero threads means the number of hardware threads.
+    explicit Scheduler(std::size_t num_threads = 0ULL, std::uint64_t slice_steps = 10000ULL);
+    Scheduler(Scheduler const&) = delete;
+    Scheduler& operator=(Scheduler const&) = delete;
+
+    std::size_t num_threads() const { return num_threads_; }
+    std::uint64_t slice_steps() const { return slice_steps_; }
+
+    void set_on_done(Callback const& callback) { on_done_ = callback; }
+
+    // The interpreter must outlive its run by the scheduler. It can be added
+    // also from the callback, while the scheduler runs.
+    Id add(Interpreter* interpreter, Interpreter::Budget const& budget = {});
+
+    // Runs all added interpreters until they are done. An exception thrown
+    // during a slice terminates the run of that interpreter only. The first
+    // exception thrown by the callback is rethrown, once all workers finished.
+    void run();
+
+private:
+    struct Task
+    {
+        Id id;
+        Interpreter* interpreter;
+        Interpreter::Budget budget;
+        std::uint64_t start_steps;
+        double num_seconds;
+    };
+
+    // Returns true, if the execution of the task is done.
+    bool run_slice(Task& task) const;
+
+    std::size_t num_threads_;
+    std::uint64_t slice_steps_;
+    Callback on_done_;
+    std::mutex mutex_;
+    std::condition_variable ready_changed_;
+    std::deque<Task> ready_;
+    std::size_t num_running_;
+    Id next_id_;
+};
+
+
+}
+
+#endif
@@ -1,9 +1,9 @@
 #ifndef SALA_STREAMING_HPP_INCLUDED
 #   define SALA_STREAMING_HPP_INCLUDED
 
-#   include <iosfwd>
+#   include <ios>
 
-namespace sala::detail { void enable_json_comments(bool state); }
+namespace sala::detail { int json_comments_index(); }
 
 namespace sala {
 
@@ -14,11 +14,11 @@ struct Instruction;
 
 template<typename ElementType, typename Traits>
 std::basic_ostream<ElementType, Traits>& enable_json_comments(std::basic_ostream<ElementType, Traits>& ostr)
-{ detail::enable_json_comments(true); return ostr; }
+{ ostr.iword(detail::json_comments_index()) = 1L; return ostr; }
 
 template<typename ElementType, typename Traits>
 std::basic_ostream<ElementType, Traits>& disable_json_comments(std::basic_ostream<ElementType, Traits>& ostr)
-{ detail::enable_json_comments(false); return ostr; }
+{ ostr.iword(detail::json_comments_index()) = 0L; return ostr; }
 
 
 std::ostream& operator<<(std::ostream& ostr, Program const& program);
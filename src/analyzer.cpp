@@ -3,8 +3,18 @@
 namespace sala {
 
 
-Analyzer::Analyzer(ExecState* const state)
+Analyzer::OpcodeMask Analyzer::opcodes(std::initializer_list<Instruction::Opcode> const list)
+{
+    OpcodeMask mask{};
+    for (Instruction::Opcode const opcode : list)
+        mask.set((std::size_t)opcode);
+    return mask;
+}
+
+
+Analyzer::Analyzer(ExecState* const state, OpcodeMask const& interests)
     : state_{ state }
+    , interests_{ interests }
     , post_operation_{}
     , extern_function_processors_{}
 {}
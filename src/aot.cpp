@@ -0,0 +1,469 @@
+#include <sala/aot.hpp>
+#include <sala/streaming.hpp>
+#include <utility/assumptions.hpp>
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+#if !defined(_WIN32)
+#   define SALA_AOT_DLOPEN
+#   include <dlfcn.h>
+#   include <fcntl.h>
+#   include <spawn.h>
+#   include <sys/stat.h>
+#   include <sys/wait.h>
+#   include <unistd.h>
+extern char** environ;
+#endif
+
+namespace sala {
+
+
+struct AotModule::Entry
+{
+    std::uint32_t func_idx;
+    std::uint32_t block_idx;
+    std::uint32_t num_instructions;
+    std::uint32_t (*code)(void const* const*);
+};
+
+
+static char const* unsigned_type(std::size_t const num_bytes)
+{
+    switch (num_bytes)
+    {
+        case 1ULL: return "std::uint8_t";
+        case 2ULL: return "std::uint16_t";
+        case 4ULL: return "std::uint32_t";
+        case 8ULL: return "std::uint64_t";
+        default: return nullptr;
+    }
+}
+
+
+static char const* signed_type(std::size_t const num_bytes)
+{
+    switch (num_bytes)
+    {
+        case 1ULL: return "std::int8_t";
+        case 2ULL: return "std::int16_t";
+        case 4ULL: return "std::int32_t";
+        case 8ULL: return "std::int64_t";
+        default: return nullptr;
+    }
+}
+
+
+static char const* floating_type(std::size_t const num_bytes)
+{
+    switch (num_bytes)
+    {
+        case 4ULL: return "float";
+        case 8ULL: return "double";
+        default: return nullptr;
+    }
+}
+
+
+static char const* binary_operator(Instruction::Opcode const opcode)
+{
+    switch (opcode)
+    {
+        case Instruction::Opcode::ADD: return "+";
+        case Instruction::Opcode::SUB: return "-";
+        case Instruction::Opcode::MUL: return "*";
+        case Instruction::Opcode::AND: return "&";
+        case Instruction::Opcode::OR: return "|";
+        case Instruction::Opcode::XOR: return "^";
+        case Instruction::Opcode::LESS: return "<";
+        case Instruction::Opcode::LESS_EQUAL: return "<=";
+        case Instruction::Opcode::GREATER: return ">";
+        case Instruction::Opcode::GREATER_EQUAL: return ">=";
+        case Instruction::Opcode::EQUAL: return "==";
+        case Instruction::Opcode::UNEQUAL: return "!=";
+        default: return nullptr;
+    }
+}
+
+
+// Appends the C++ statements of the instruction and returns true, or returns false,
+// if the instruction is not supported.
+static bool translate_instruction(
+    DecodedFunction const& decoded_function,
+    DecodedInstruction const& decoded,
+    bool const is_last,
+    std::ostream& out
+    )
+{
+    if (decoded.handler == nullptr || decoded.transfers_control != is_last)
+        return false;
+
+    Instruction const& instruction{ *decoded.instruction };
+    std::uint32_t const begin{ decoded.operands_begin };
+    std::uint32_t const num_operands{ decoded.operands_end - decoded.operands_begin };
+    auto const num_bytes = [&decoded_function, begin](std::uint32_t const i) {
+        return decoded_function.operands().at(begin + i).num_bytes;
+    };
+    bool const is_floating{
+        instruction.modifier() == Instruction::Modifier::FLOATING ||
+        instruction.modifier() == Instruction::Modifier::FLOATING_UNORDERED
+        };
+
+    switch (instruction.opcode())
+    {
+        case Instruction::Opcode::NOP:
+            return true;
+
+        case Instruction::Opcode::COPY:
+            if (num_operands != 2U || num_bytes(0U) != num_bytes(1U))
+                return false;
+            out << "    std::memmove(sala_bytes(t, " << begin << "U), sala_bytes(t, " << begin + 1U << "U), " << num_bytes(0U) << "U);\n";
+            return true;
+
+        case Instruction::Opcode::ADD:
+        case Instruction::Opcode::SUB:
+        case Instruction::Opcode::MUL:
+        case Instruction::Opcode::AND:
+        case Instruction::Opcode::OR:
+        case Instruction::Opcode::XOR:
+        {
+            if (num_operands != 3U || num_bytes(1U) != num_bytes(0U) || num_bytes(2U) != num_bytes(0U))
+                return false;
+            char const* const op{ binary_operator(instruction.opcode()) };
+            if (is_floating)
+            {
+                char const* const type{ floating_type(num_bytes(0U)) };
+                if (type == nullptr)
+                    return false;
+                out << "    sala_st<" << type << ">(t, " << begin << "U, (" << type << ")(sala_ld<" << type << ">(t, " << begin + 1U
+                    << "U) " << op << " sala_ld<" << type << ">(t, " << begin + 2U << "U)));\n";
+                return true;
+            }
+            // The computation in 64 bits avoids both the integer promotion and the undefined signed overflow.
+            char const* const type{ unsigned_type(num_bytes(0U)) };
+            if (type == nullptr)
+                return false;
+            out << "    sala_st<" << type << ">(t, " << begin << "U, (" << type << ")((std::uint64_t)sala_ld<" << type << ">(t, " << begin + 1U
+                << "U) " << op << " (std::uint64_t)sala_ld<" << type << ">(t, " << begin + 2U << "U)));\n";
+            return true;
+        }
+
+        case Instruction::Opcode::LESS:
+        case Instruction::Opcode::LESS_EQUAL:
+        case Instruction::Opcode::GREATER:
+        case Instruction::Opcode::GREATER_EQUAL:
+        case Instruction::Opcode::EQUAL:
+        case Instruction::Opcode::UNEQUAL:
+        {
+            if (num_operands != 3U || num_bytes(0U) != 1ULL || num_bytes(2U) != num_bytes(1U))
+                return false;
+            char const* type;
+            switch (instruction.modifier())
+            {
+                case Instruction::Modifier::SIGNED: type = signed_type(num_bytes(1U)); break;
+                case Instruction::Modifier::UNSIGNED: type = unsigned_type(num_bytes(1U)); break;
+                case Instruction::Modifier::FLOATING: type = floating_type(num_bytes(1U)); break;
+                default: type = nullptr; break;
+            }
+            if (type == nullptr)
+                return false;
+            out << "    sala_st<std::uint8_t>(t, " << begin << "U, (std::uint8_t)(sala_ld<" << type << ">(t, " << begin + 1U
+                << "U) " << binary_operator(instruction.opcode()) << " sala_ld<" << type << ">(t, " << begin + 2U << "U)));\n";
+            return true;
+        }
+
+        case Instruction::Opcode::JUMP:
+            out << "    return " << decoded.successors.front() << "U;\n";
+            return true;
+
+        case Instruction::Opcode::BRANCH:
+            if (num_operands != 1U)
+                return false;
+            out << "    return sala_ld<std::uint8_t>(t, " << begin << "U) == 0U ? "
+                << decoded.successors.front() << "U : " << decoded.successors.back() << "U;\n";
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+static std::uint64_t fnv1a_hash(std::string const& text)
+{
+    std::uint64_t hash{ 14695981039346656037ULL };
+    for (char const c : text)
+        hash = (hash ^ (std::uint8_t)c) * 1099511628211ULL;
+    return hash;
+}
+
+
+static std::shared_ptr<AotModule const> fail(std::string* const error_message, std::string const& message)
+{
+    if (error_message != nullptr)
+        *error_message = message;
+    return nullptr;
+}
+
+
+#if defined(SALA_AOT_DLOPEN)
+// Returns true, if the path is a directory (or a regular file), which is not a symbolic
+// link, is owned by the effective user and is not writable by the group or others.
+static bool is_private(std::filesystem::path const& path, bool const directory)
+{
+    struct stat info;
+    if (lstat(path.c_str(), &info) != 0)
+        return false;
+    return (directory ? S_ISDIR(info.st_mode) : S_ISREG(info.st_mode)) &&
+           info.st_uid == geteuid() &&
+           (info.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+
+// Runs the command, i.e., the program args[0] (searched in PATH) with the arguments,
+// without a shell, and with its output redirected to the log file. Returns true,
+// if the command succeeded.
+static bool run_command(std::vector<std::string> const& args, std::filesystem::path const& log_path)
+{
+    std::vector<char*> argv;
+    for (std::string const& arg : args)
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    if (posix_spawn_file_actions_init(&actions) != 0)
+        return false;
+    pid_t pid{ 0 };
+    bool const spawned{
+        posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, log_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR) == 0 &&
+        posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO) == 0 &&
+        posix_spawnp(&pid, argv.front(), &actions, nullptr, argv.data(), environ) == 0
+        };
+    posix_spawn_file_actions_destroy(&actions);
+    if (!spawned)
+        return false;
+
+    int status{ 0 };
+    while (waitpid(pid, &status, 0) == -1)
+        if (errno != EINTR)
+            return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+#endif
+
+
+bool AotModule::is_supported()
+{
+#if defined(SALA_AOT_DLOPEN)
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+std::uint64_t AotModule::hash_program(DecodedProgram const& program)
+{
+    std::ostringstream text;
+    text << program.program();
+    return fnv1a_hash(text.str());
+}
+
+
+std::string AotModule::translate(DecodedProgram const& program)
+{
+    std::ostringstream out;
+    out << "// Generated by sala::AotModule.\n"
+        << "#include <cstdint>\n"
+        << "#include <cstring>\n"
+        << "\n"
+        << "using sala_table = void const* const*;\n"
+        << "\n"
+        << "static inline unsigned char* sala_bytes(sala_table const t, std::uint32_t const i)\n"
+        << "{\n"
+        << "    unsigned char* data;\n"
+        << "    std::memcpy(&data, (unsigned char const*)t[i] + " << MemBlock::data_member_offset() << "U, sizeof(data));\n"
+        << "    unsigned char* bytes;\n"
+        << "    std::memcpy(&bytes, data + " << detail::MemBlockData::start_member_offset() << "U, sizeof(bytes));\n"
+        << "    return bytes;\n"
+        << "}\n"
+        << "\n"
+        << "template<typename T>\n"
+        << "static inline T sala_ld(sala_table const t, std::uint32_t const i)\n"
+        << "{ T value; std::memcpy(&value, sala_bytes(t, i), sizeof(T)); return value; }\n"
+        << "\n"
+        << "template<typename T>\n"
+        << "static inline void sala_st(sala_table const t, std::uint32_t const i, T const value)\n"
+        << "{ std::memcpy(sala_bytes(t, i), &value, sizeof(T)); }\n"
+        << "\n"
+        << "struct sala_entry { std::uint32_t func_idx; std::uint32_t block_idx; std::uint32_t num_instructions; std::uint32_t (*code)(sala_table); };\n";
+
+    std::ostringstream entries;
+    for (std::uint32_t func_idx = 0U; func_idx != (std::uint32_t)program.functions().size(); ++func_idx)
+    {
+        DecodedFunction const& decoded_function{ program.function(func_idx) };
+        std::vector<BasicBlock> const& blocks{ decoded_function.function().basic_blocks() };
+        for (std::uint32_t block_idx = 0U; block_idx != (std::uint32_t)blocks.size(); ++block_idx)
+        {
+            std::size_t const num_instructions{ blocks.at(block_idx).instructions().size() };
+            std::ostringstream body;
+            bool translated{ num_instructions != 0ULL };
+            for (std::size_t i = 0ULL; translated && i != num_instructions; ++i)
+                translated = translate_instruction(
+                    decoded_function,
+                    decoded_function.instruction(block_idx, (std::uint32_t)i),
+                    i + 1ULL == num_instructions,
+                    body
+                    );
+            if (!translated)
+                continue;
+
+            std::string const name{ "sala_block_" + std::to_string(func_idx) + "_" + std::to_string(block_idx) };
+            out << "\n"
+                << "// " << decoded_function.function().name() << ", block " << block_idx << "\n"
+                << "static std::uint32_t " << name << "(sala_table const t)\n"
+                << "{\n"
+                << body.str()
+                << "}\n";
+            entries << "    { " << func_idx << "U, " << block_idx << "U, " << num_instructions << "U, &" << name << " },\n";
+        }
+    }
+
+    out << "\n"
+        << "static sala_entry const sala_entries[] = {\n"
+        << entries.str()
+        << "    { 0U, 0U, 0U, nullptr }\n"
+        << "};\n"
+        << "\n"
+        << "extern \"C\" sala_entry const* sala_aot_entries() { return sala_entries; }\n"
+        << "extern \"C\" std::uint64_t sala_aot_program_hash() { return " << hash_program(program) << "ULL; }\n";
+    return out.str();
+}
+
+
+std::shared_ptr<AotModule const> AotModule::load(
+    DecodedProgram const& program,
+    Options const& options,
+    std::string* const error_message
+    )
+{
+#if defined(SALA_AOT_DLOPEN)
+    namespace fs = std::filesystem;
+
+    std::string compiler{ options.compiler };
+    if (compiler.empty())
+        compiler = std::getenv("CXX") != nullptr ? std::getenv("CXX") : "c++";
+
+    std::uint64_t const program_hash{ hash_program(program) };
+    std::string const source{ translate(program) };
+    std::uint64_t const hash{ fnv1a_hash(compiler + "\n" + options.compiler_flags + "\n" + source) };
+
+    std::error_code error;
+    fs::path cache_dir{ options.cache_dir };
+    if (cache_dir.empty())
+    {
+        cache_dir = fs::temp_directory_path(error) / ("sala_aot_" + std::to_string(geteuid()));
+        if (error)
+            return fail(error_message, "Cannot find the temporary directory: " + error.message());
+    }
+    if (cache_dir.has_parent_path())
+        fs::create_directories(cache_dir.parent_path(), error);
+    if (error || (mkdir(cache_dir.c_str(), S_IRWXU) != 0 && errno != EEXIST))
+        return fail(error_message, "Cannot create the cache directory '" + cache_dir.string() + "'.");
+    if (!is_private(cache_dir, true))
+        return fail(error_message, "The cache directory '" + cache_dir.string() + "' is not a directory owned by the user and writable only by the user.");
+
+    std::ostringstream name;
+    name << "sala_aot_" << std::hex << hash;
+    fs::path const library_path{ cache_dir / (name.str() + ".so") };
+
+    if (!fs::exists(library_path, error))
+    {
+        // Concurrent builds of the same program use different temporary files
+        // and the last rename wins, with the same content.
+        std::string const unique{ std::to_string(getpid()) + "_" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) };
+        fs::path const source_path{ cache_dir / (name.str() + "_" + unique + ".cpp") };
+        fs::path const temp_path{ cache_dir / (name.str() + "_" + unique + ".so") };
+        fs::path const log_path{ cache_dir / (name.str() + ".log") };
+        {
+            std::ofstream file{ source_path, std::ios::binary };
+            file << source;
+            if (!file.good())
+                return fail(error_message, "Cannot write the file '" + source_path.string() + "'.");
+        }
+
+        // The compiler is one argument, the flags are separated by white space.
+        std::vector<std::string> command{ compiler };
+        {
+            std::istringstream flags{ options.compiler_flags };
+            for (std::string flag; flags >> flag; )
+                command.push_back(flag);
+        }
+        for (std::string const arg : { "-shared", "-fPIC", "-o" })
+            command.push_back(arg);
+        command.push_back(temp_path.string());
+        command.push_back(source_path.string());
+        bool const built{ run_command(command, log_path) };
+        fs::remove(source_path, error);
+        if (!built)
+        {
+            fs::remove(temp_path, error);
+            return fail(error_message, "The build of the translated program failed, see '" + log_path.string() + "'.");
+        }
+        fs::remove(log_path, error);
+        fs::rename(temp_path, library_path, error);
+        if (error)
+            return fail(error_message, "Cannot move the built library to '" + library_path.string() + "': " + error.message());
+    }
+
+    if (!is_private(library_path, false))
+        return fail(error_message, "The library '" + library_path.string() + "' is not a file owned by the user and writable only by the user.");
+    void* const handle{ dlopen(library_path.c_str(), RTLD_NOW | RTLD_LOCAL) };
+    if (handle == nullptr)
+        return fail(error_message, std::string{ "Cannot load the library: " } + dlerror());
+    std::shared_ptr<AotModule> module{ new AotModule{ hash, program_hash, library_path.string(), handle } };
+
+    auto const entries{ (Entry const* (*)())dlsym(handle, "sala_aot_entries") };
+    auto const library_program_hash{ (std::uint64_t (*)())dlsym(handle, "sala_aot_program_hash") };
+    if (entries == nullptr || library_program_hash == nullptr)
+        return fail(error_message, "The library '" + library_path.string() + "' does not export 'sala_aot_entries' and 'sala_aot_program_hash'.");
+    if (library_program_hash() != program_hash)
+        return fail(error_message, "The library '" + library_path.string() + "' does not match the program.");
+    for (Entry const* entry = entries(); entry->code != nullptr; ++entry)
+    {
+        if (entry->func_idx >= program.functions().size() ||
+                entry->block_idx >= program.function(entry->func_idx).function().basic_blocks().size())
+            return fail(error_message, "The library '" + library_path.string() + "' does not match the program.");
+        module->blocks_.push_back({ entry->func_idx, entry->block_idx, entry->num_instructions, (Jit::Code)entry->code });
+    }
+    return module;
+#else
+    (void)program;
+    (void)options;
+    return fail(error_message, "The ahead-of-time compilation is not supported on this platform.");
+#endif
+}
+
+
+AotModule::AotModule(std::uint64_t const hash, std::uint64_t const program_hash, std::string const& path, void* const handle)
+    : hash_{ hash }
+    , program_hash_{ program_hash }
+    , path_{ path }
+    , handle_{ handle }
+    , blocks_{}
+{}
+
+
+AotModule::~AotModule()
+{
+#if defined(SALA_AOT_DLOPEN)
+    if (handle_ != nullptr)
+        dlclose(handle_);
+#endif
+}
+
+
+}
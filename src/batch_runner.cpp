@@ -0,0 +1,174 @@
+#include <sala/batch_runner.hpp>
+#include <sala/sanitizer.hpp>
+#include <sala/extern_code_cstd.hpp>
+#include <utility/assumptions.hpp>
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace sala {
+
+
+struct BatchRunner::WorkQueue
+{
+    std::mutex mutex{};
+    std::deque<std::size_t> indices{};
+
+    bool pop_front(std::size_t& index)
+    {
+        std::lock_guard<std::mutex> const lock{ mutex };
+        if (indices.empty())
+            return false;
+        index = indices.front();
+        indices.pop_front();
+        return true;
+    }
+
+    bool pop_back(std::size_t& index)
+    {
+        std::lock_guard<std::mutex> const lock{ mutex };
+        if (indices.empty())
+            return false;
+        index = indices.back();
+        indices.pop_back();
+        return true;
+    }
+};
+
+
+struct BatchRunner::Worker
+{
+    explicit Worker(BatchRunner const& runner);
+    Worker(Worker const&) = delete;
+    Worker& operator=(Worker const&) = delete;
+
+    Result run(std::size_t index, Input const& input);
+
+    ExecState state;
+    std::unique_ptr<Sanitizer> sanitizer;
+    ExternCodeCStd extern_code;
+    Interpreter interpreter;
+    // Taken at the start of the entry function, or when the static initializer failed.
+    ExecState::Snapshot snapshot;
+};
+
+
+BatchRunner::Worker::Worker(BatchRunner const& runner)
+    : state{ runner.decoded_program_, 0, nullptr, runner.memory_size_in_bytes_ }
+    , sanitizer{ runner.sanitize_ ? std::make_unique<Sanitizer>(&state) : nullptr }
+    , extern_code{ &state, sanitizer.get() }
+    , interpreter{ &state, &extern_code, sanitizer != nullptr ? std::vector<Analyzer*>{ sanitizer.get() } : std::vector<Analyzer*>{} }
+    , snapshot{}
+{
+    while (!interpreter.done() && state.stage() == ExecState::Stage::INITIALIZING)
+        interpreter.run_slice(1ULL);
+    snapshot = state.snapshot();
+}
+
+
+BatchRunner::Result BatchRunner::Worker::run(std::size_t const index, Input const& input)
+{
+    std::vector<char*> argv;
+    argv.reserve(input.args.size() + 1ULL);
+    for (std::string const& arg : input.args)
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    state.restore(snapshot);
+    if (state.stage() != ExecState::Stage::FINISHED)
+        state.set_command_line((int)input.args.size(), argv.data());
+    if (sanitizer != nullptr)
+        sanitizer->reset();
+    extern_code.reset();
+
+    std::uint64_t const start_steps{ interpreter.num_steps() };
+    interpreter.run(input.budget);
+
+    Result result;
+    result.index = index;
+    result.termination = state.termination();
+    result.exit_code = state.exit_code();
+    result.num_steps = interpreter.num_steps() - start_steps;
+    result.report = state.report();
+    return result;
+}
+
+
+BatchRunner::BatchRunner(
+    Program const* const P,
+    std::size_t const num_threads,
+    bool const sanitize,
+    std::size_t const memory_size_in_bytes
+    )
+    : decoded_program_{ std::make_shared<DecodedProgram const>(*P) }
+    , num_threads_{ num_threads != 0ULL ? num_threads : std::max<std::size_t>(std::thread::hardware_concurrency(), 1ULL) }
+    , sanitize_{ sanitize }
+    , memory_size_in_bytes_{ memory_size_in_bytes }
+{
+    ASSUMPTION(P->is_frozen());
+}
+
+
+std::vector<BatchRunner::Result> BatchRunner::run(std::vector<Input> const& inputs) const
+{
+    std::vector<Result> results(inputs.size());
+    run(inputs, [&results](Result const& result) { results.at(result.index) = result; });
+    return results;
+}
+
+
+void BatchRunner::run(std::vector<Input> const& inputs, Callback const& callback) const
+{
+    std::size_t const num_workers{ std::min(num_threads(), std::max<std::size_t>(inputs.size(), 1ULL)) };
+    std::vector<WorkQueue> queues(num_workers);
+    for (std::size_t i = 0ULL; i != inputs.size(); ++i)
+        queues.at(i * num_workers / inputs.size()).indices.push_back(i);
+
+    std::mutex callback_mutex;
+    std::mutex error_mutex;
+    std::exception_ptr error{ nullptr };
+
+    auto const worker = [&](std::size_t const worker_index) {
+        try
+        {
+            std::unique_ptr<Worker> context{ nullptr };
+            while (true)
+            {
+                std::size_t index;
+                bool found{ queues.at(worker_index).pop_front(index) };
+                for (std::size_t i = 1ULL; !found && i != num_workers; ++i)
+                    found = queues.at((worker_index + i) % num_workers).pop_back(index);
+                if (!found)
+                    break;
+
+                if (context == nullptr)
+                    context = std::make_unique<Worker>(*this);
+                Result const result{ context->run(index, inputs.at(index)) };
+                std::lock_guard<std::mutex> const lock{ callback_mutex };
+                callback(result);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> const lock{ error_mutex };
+            if (error == nullptr)
+                error = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_workers - 1ULL);
+    for (std::size_t i = 1ULL; i < num_workers; ++i)
+        threads.push_back(std::thread{ worker, i });
+    worker(0ULL);
+    for (std::thread& thread : threads)
+        thread.join();
+
+    if (error != nullptr)
+        std::rethrow_exception(error);
+}
+
+
+}
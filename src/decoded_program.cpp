@@ -0,0 +1,275 @@
+#include <sala/decoded_program.hpp>
+#include <sala/memblock_allocator.hpp>
+#include <utility/invariants.hpp>
+#include <algorithm>
+#include <new>
+#include <cstring>
+#if defined(_WIN32)
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#endif
+
+namespace sala {
+
+
+static bool decode_operand(Program const& P, Function const& F, Instruction::Descriptor const descriptor, std::uint32_t const index, DecodedOperand& operand)
+{
+    operand.descriptor = descriptor;
+    operand.index = index;
+    switch (descriptor)
+    {
+    case Instruction::Descriptor::STATIC:
+        if (index >= P.static_variables().size())
+            return false;
+        operand.num_bytes = P.static_variables()[index].num_bytes();
+        return true;
+    case Instruction::Descriptor::LOCAL:
+        if (index >= F.local_variables().size())
+            return false;
+        operand.num_bytes = F.local_variables()[index].num_bytes();
+        return true;
+    case Instruction::Descriptor::PARAMETER:
+        if (index >= F.parameters().size())
+            return false;
+        operand.num_bytes = F.parameters()[index].num_bytes();
+        return true;
+    case Instruction::Descriptor::CONSTANT:
+        if (index >= P.constants().size())
+            return false;
+        operand.num_bytes = P.constants()[index].num_bytes();
+        return true;
+    case Instruction::Descriptor::FUNCTION:
+        if (index >= P.functions().size())
+            return false;
+        operand.num_bytes = 1ULL;
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+DecodedFunction::DecodedFunction(
+    Program const& P,
+    Function const& F,
+    std::uint32_t const first_instruction,
+    std::uint32_t const first_call_site
+    )
+    : function_{ &F }
+    , instructions_{}
+    , blocks_{}
+    , operands_{}
+    , num_call_sites_{ 0U }
+    , initial_stack_bytes_{ F.initial_stack_bytes() }
+{
+    for (auto const& block : F.basic_blocks())
+    {
+        blocks_.push_back((std::uint32_t)instructions_.size());
+        for (auto const& instruction : block.instructions())
+        {
+            DecodedInstruction decoded;
+            decoded.index = first_instruction + (std::uint32_t)instructions_.size();
+            decoded.instruction = &instruction;
+            decoded.transfers_control = InstrSwitch::transfers_control(instruction.opcode());
+            decoded.changes_stack = instruction.opcode() == Instruction::Opcode::CALL ||
+                                    instruction.opcode() == Instruction::Opcode::RET;
+            decoded.operands_begin = (std::uint32_t)operands_.size();
+
+            bool valid{ instruction.opcode() != Instruction::Opcode::__INVALID__ };
+            for (std::size_t i = 0ULL; i != instruction.operands().size(); ++i)
+            {
+                operands_.push_back({});
+                if (!decode_operand(P, F, instruction.descriptors().at(i), instruction.operands().at(i), operands_.back()))
+                    valid = false;
+            }
+            decoded.operands_end = (std::uint32_t)operands_.size();
+
+            if (valid)
+                decoded.handler = InstrSwitch::decode(
+                        instruction,
+                        decoded.operands_begin == decoded.operands_end ? 0ULL : operands_.at(decoded.operands_begin).num_bytes,
+                        decoded.operands_begin == decoded.operands_end ? 0ULL : operands_.at(decoded.operands_end - 1U).num_bytes
+                        );
+
+            if (valid && decoded.operands_begin != decoded.operands_end)
+            {
+                DecodedOperand const& last{ operands_.at(decoded.operands_end - 1U) };
+                if (last.descriptor == Instruction::Descriptor::CONSTANT && last.num_bytes <= sizeof(decoded.immediate))
+                    std::memcpy(&decoded.immediate, P.constants().at(last.index).bytes().data(), last.num_bytes);
+            }
+
+            if (!block.successors().empty())
+                decoded.successors = { block.successors().front(), block.successors().back() };
+
+            if (instruction.opcode() == Instruction::Opcode::CALL && !instruction.descriptors().empty() &&
+                    instruction.descriptors().front() != Instruction::Descriptor::FUNCTION)
+                decoded.call_site = first_call_site + num_call_sites_++;
+
+            instructions_.push_back(decoded);
+        }
+    }
+
+    for (std::size_t i = 0ULL; i != blocks_.size(); ++i)
+    {
+        DecodedInstruction* const end{ instructions_.data() + (i + 1ULL == blocks_.size() ? instructions_.size() : blocks_.at(i + 1ULL)) };
+        for (DecodedInstruction* decoded = instructions_.data() + blocks_.at(i); decoded != end; ++decoded)
+            decoded->fusion = detect_fusion(decoded, end);
+    }
+}
+
+
+std::uint32_t DecodedFunction::num_fused_instructions(DecodedInstruction::Fusion const fusion)
+{
+    switch (fusion)
+    {
+        case DecodedInstruction::Fusion::NONE: return 1U;
+        case DecodedInstruction::Fusion::COMPARE_BRANCH: return 2U;
+        case DecodedInstruction::Fusion::LOAD_COMPUTE_STORE: return 3U;
+        case DecodedInstruction::Fusion::ADDRESS_MOVEPTR_LOAD: return 3U;
+        default: UNREACHABLE(); return 1U;
+    }
+}
+
+
+bool DecodedFunction::same_operand(
+    DecodedInstruction const& left,
+    std::uint32_t const left_idx,
+    DecodedInstruction const& right,
+    std::uint32_t const right_idx
+    ) const
+{
+    if (left.operands_begin + left_idx >= left.operands_end || right.operands_begin + right_idx >= right.operands_end)
+        return false;
+    DecodedOperand const& l{ operands_.at(left.operands_begin + left_idx) };
+    DecodedOperand const& r{ operands_.at(right.operands_begin + right_idx) };
+    return l.descriptor == r.descriptor && l.index == r.index;
+}
+
+
+DecodedInstruction::Fusion DecodedFunction::detect_fusion(DecodedInstruction const* const first, DecodedInstruction const* const end) const
+{
+    using Opcode = Instruction::Opcode;
+    using Fusion = DecodedInstruction::Fusion;
+
+    auto const opcode = [first, end](std::uint32_t const i) {
+        return first + i < end && first[i].handler != nullptr ? first[i].instruction->opcode() : Opcode::__INVALID__;
+    };
+    auto const num_operands = [first](std::uint32_t const i) {
+        return first[i].operands_end - first[i].operands_begin;
+    };
+
+    switch (opcode(0U))
+    {
+        case Opcode::LESS:
+        case Opcode::LESS_EQUAL:
+        case Opcode::GREATER:
+        case Opcode::GREATER_EQUAL:
+        case Opcode::EQUAL:
+        case Opcode::UNEQUAL:
+            if (opcode(1U) == Opcode::BRANCH && same_operand(first[0], 0U, first[1], 0U))
+                return Fusion::COMPARE_BRANCH;
+            break;
+
+        case Opcode::LOAD:
+            switch (opcode(1U))
+            {
+                case Opcode::ADD:
+                case Opcode::SUB:
+                case Opcode::MUL:
+                case Opcode::AND:
+                case Opcode::OR:
+                case Opcode::XOR:
+                case Opcode::SHL:
+                case Opcode::SHR:
+                    if (opcode(2U) == Opcode::STORE &&
+                            num_operands(0U) == 2U && num_operands(1U) == 3U && num_operands(2U) == 2U &&
+                            (same_operand(first[0], 0U, first[1], 1U) || same_operand(first[0], 0U, first[1], 2U)) &&
+                            same_operand(first[0], 1U, first[2], 0U) &&
+                            same_operand(first[1], 0U, first[2], 1U))
+                        return Fusion::LOAD_COMPUTE_STORE;
+                    break;
+                default: break;
+            }
+            break;
+
+        case Opcode::ADDRESS:
+            if (opcode(1U) == Opcode::MOVEPTR &&
+                    opcode(2U) == Opcode::LOAD &&
+                    num_operands(0U) == 2U && num_operands(1U) == 4U && num_operands(2U) == 2U &&
+                    same_operand(first[0], 0U, first[1], 1U) &&
+                    same_operand(first[1], 0U, first[2], 1U))
+                return Fusion::ADDRESS_MOVEPTR_LOAD;
+            break;
+
+        default: break;
+    }
+    return Fusion::NONE;
+}
+
+
+DecodedProgram::DecodedProgram(Program const& P)
+    : program_{ &P }
+    , functions_{}
+    , num_instructions_{ 0U }
+    , num_call_sites_{ 0U }
+    , constant_bytes_{}
+    , constant_offsets_{}
+{
+    functions_.reserve(P.functions().size());
+    for (auto const& func : P.functions())
+    {
+        functions_.push_back(DecodedFunction{ P, func, num_instructions_, num_call_sites_ });
+        num_instructions_ += (std::uint32_t)functions_.back().instructions().size();
+        num_call_sites_ += functions_.back().num_call_sites();
+    }
+
+    // The constants are laid out like memory blocks in a slab (see MemBlock::push_back_slab).
+    std::size_t num_bytes{ 0ULL };
+    constant_offsets_.reserve(P.constants().size());
+    for (auto const& constant : P.constants())
+    {
+        std::size_t alignment{ 1ULL };
+        while (alignment < MemBlockAllocator::alignment && 2ULL * alignment <= constant.num_bytes())
+            alignment *= 2ULL;
+        num_bytes = (num_bytes + alignment - 1ULL) & ~(alignment - 1ULL);
+        constant_offsets_.push_back(num_bytes);
+        // At least one byte of padding follows each constant, so that a pointer one past
+        // the end of a constant never points to the next constant.
+        num_bytes += constant.num_bytes() + 1ULL;
+    }
+    num_bytes = std::max<std::size_t>(num_bytes, 1ULL);
+#if defined(_WIN32)
+    void* const memory{ VirtualAlloc(nullptr, num_bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE) };
+    if (memory == nullptr)
+        throw std::bad_alloc{};
+#else
+    void* const memory{ mmap(nullptr, num_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+    if (memory == MAP_FAILED)
+        throw std::bad_alloc{};
+#endif
+    constant_bytes_ = std::unique_ptr<std::uint8_t[], ConstantBytesDeleter>{ (std::uint8_t*)memory, ConstantBytesDeleter{ num_bytes } };
+    for (std::size_t i = 0ULL; i != P.constants().size(); ++i)
+        std::memcpy(constant_bytes_.get() + constant_offsets_.at(i), P.constants().at(i).bytes().data(), P.constants().at(i).num_bytes());
+    // The constants are shared by all execution states (and threads) of the decoded program,
+    // and the immediates of the decoded instructions are copied from them.
+#if defined(_WIN32)
+    DWORD old_protection;
+    VirtualProtect(memory, num_bytes, PAGE_READONLY, &old_protection);
+#else
+    mprotect(memory, num_bytes, PROT_READ);
+#endif
+}
+
+
+void DecodedProgram::ConstantBytesDeleter::operator()(std::uint8_t* const bytes) const
+{
+#if defined(_WIN32)
+    VirtualFree(bytes, 0, MEM_RELEASE);
+#else
+    munmap(bytes, num_bytes);
+#endif
+}
+
+
+}
@@ -1,10 +1,14 @@
 #include <sala/exec_state.hpp>
+#include <sala/decoded_program.hpp>
 #include <sala/pointer_model_default.hpp>
 #include <sala/pointer_model_m32.hpp>
 #include <utility/assumptions.hpp>
 #include <utility/invariants.hpp>
+#include <algorithm>
+#include <iterator>
 #include <cstring>
 #include <sstream>
+#include <type_traits>
 
 namespace sala {
 
@@ -29,38 +33,62 @@ void InstrPointer::jump(std::uint32_t const new_block_idx)
 
 
 StackRecord::StackRecord()
-    : function_index_{ 0U }
+    : allocator_{ MemBlockAllocator::heap() }
+    , pointer_model_{ nullptr }
+    , function_index_{ 0U }
     , ip_{}
     , parameters_{}
     , locals_{}
     , variadic_parameters_{}
+    , operand_table_{}
 {}
 
 
 StackRecord::StackRecord(PointerModel* const pointer_model, Function const& F)
-    : pointer_model_{ pointer_model }
+    : StackRecord{ MemBlockAllocator::heap(), pointer_model, F }
+{}
+
+
+StackRecord::StackRecord(MemBlockAllocator* const allocator, PointerModel* const pointer_model, Function const& F)
+    : allocator_{ allocator }
+    , pointer_model_{ pointer_model }
     , function_index_{ F.index() }
     , ip_{}
     , parameters_{}
     , locals_{}
     , variadic_parameters_{}
+    , operand_table_{}
 {
+    std::vector<std::size_t> sizes;
+    sizes.reserve(F.parameters().size() + F.local_variables().size());
     for (auto const& param : F.parameters())
-        parameters_.push_back(MemBlock{ pointer_model_, param.num_bytes() });
+        sizes.push_back(param.num_bytes());
     for (auto const& local : F.local_variables())
-        locals_.push_back(MemBlock{ pointer_model_, local.num_bytes() });
+        sizes.push_back(local.num_bytes());
+
+    // All parameters and locals of the record live in a single slab of memory.
+    parameters_.reserve(sizes.size());
+    MemBlock::push_back_slab(allocator_, pointer_model_, sizes, parameters_);
+    locals_.assign(
+        std::make_move_iterator(parameters_.begin() + F.parameters().size()),
+        std::make_move_iterator(parameters_.end())
+        );
+    parameters_.resize(F.parameters().size());
 }
 
 
 void StackRecord::push_back_variadic_parameter(std::size_t const num_bytes)
 {
-    variadic_parameters_.push_back(MemBlock{ pointer_model_, num_bytes });
+    variadic_parameters_.push_back(MemBlock{ allocator_, pointer_model_, num_bytes });
 }
 
 
 void StackRecord::push_back_local_variable(std::size_t num_bytes)
 {
-    locals_.push_back(MemBlock{ pointer_model_, num_bytes });
+    MemBlock const* const old_locals{ locals_.data() };
+    locals_.push_back(MemBlock{ allocator_, pointer_model_, num_bytes });
+    if (locals_.data() != old_locals)
+        operand_table_.clear();
 }
 
 
@@ -70,13 +98,134 @@ void StackRecord::pop_back_local_variable()
 }
 
 
+bool StackRecord::reset(Function const& F, std::uint8_t const init_value)
+{
+    ASSUMPTION(function_index_ == F.index());
+    if (parameters_.size() != F.parameters().size() || locals_.size() < F.local_variables().size())
+        return false;
+    ip_ = {};
+    variadic_parameters_.clear();
+    while (locals_.size() > F.local_variables().size())
+        locals_.pop_back();
+    for (MemBlock const& param : parameters_)
+        std::memset(param.start(), init_value, param.count());
+    for (MemBlock const& local : locals_)
+        std::memset(local.start(), init_value, local.count());
+    return true;
+}
+
+
+// The records move between the stack and the recycled records, and their operand
+// tables must stay valid, i.e., the memory blocks must not be copied.
+static_assert(std::is_nothrow_move_constructible_v<StackRecord> && std::is_nothrow_move_assignable_v<StackRecord>);
+
+
+StackSegment::StackSegment()
+    : chunks_{}
+    , size_{ 0ULL }
+    , top_{ nullptr }
+{}
+
+
+StackSegment::StackSegment(StackSegment const& other)
+    : StackSegment{}
+{
+    *this = other;
+}
+
+
+StackSegment& StackSegment::operator=(StackSegment const& other)
+{
+    if (this == &other)
+        return *this;
+    while (size_ > other.size_)
+        pop_back();
+    for (std::size_t i = 0ULL; i != size_; ++i)
+        (*this)[i] = other[i];
+    while (size_ < other.size_)
+        push_back(StackRecord{ other[size_] });
+    return *this;
+}
+
+
+StackRecord const& StackSegment::at(std::size_t const i) const
+{
+    if (i >= size_)
+        throw std::out_of_range("sala::StackSegment::at()");
+    return (*this)[i];
+}
+
+
+StackRecord& StackSegment::at(std::size_t const i)
+{
+    if (i >= size_)
+        throw std::out_of_range("sala::StackSegment::at()");
+    return (*this)[i];
+}
+
+
+void StackSegment::push_back(StackRecord&& record)
+{
+    if (size_ == chunks_.size() * chunk_size)
+        chunks_.push_back(std::make_unique<StackRecord[]>(chunk_size));
+    top_ = &(*this)[size_];
+    *top_ = std::move(record);
+    ++size_;
+}
+
+
+StackRecord StackSegment::pop_back()
+{
+    ASSUMPTION(size_ > 0ULL);
+    StackRecord record{ std::move(*top_) };
+    // The moved-from record may still own some memory.
+    *top_ = StackRecord{};
+    --size_;
+    top_ = size_ == 0ULL ? nullptr : &(*this)[size_ - 1ULL];
+    return record;
+}
+
+
+void StackSegment::clear()
+{
+    while (size_ > 0ULL)
+        pop_back();
+}
+
+
+static PointerModel* make_pointer_model(Program const& program, MemBlockAllocator const* const allocator)
+{
+    if (program.num_cpu_bits() != 32U)
+        return new PointerModelDefault();
+    // Within a flat region of less than 4GB all addresses, including the end, are 32-bit offsets.
+    auto const flat{ dynamic_cast<MemBlockAllocatorFlat const*>(allocator) };
+    if (flat != nullptr && (std::size_t)(flat->end() - flat->begin()) < (1ULL << 32U))
+        return new PointerModelM32_FlatOffset(flat->begin(), flat->end());
+    return new PointerModelM32_SegmentOffset();
+}
+
+
 ExecState::ExecState(Program const* const P, int const argc, char* argv[], std::size_t const memory_size_in_bytes)
-    : program_{ P }
-    , pointer_model_{
-        program_->num_cpu_bits() == 32U ?
-            (PointerModel*)new PointerModelM32_SegmentOffset() :
-            (PointerModel*)new PointerModelDefault()
-        }
+    : ExecState{ std::make_shared<DecodedProgram const>(*P), argc, argv, memory_size_in_bytes }
+{}
+
+
+ExecState::ExecState(std::shared_ptr<DecodedProgram const> const D, int const argc, char* argv[], std::size_t const memory_size_in_bytes)
+    : ExecState{ D, argc, argv, memory_size_in_bytes, std::make_unique<MemBlockAllocatorPools>() }
+{}
+
+
+ExecState::ExecState(
+    std::shared_ptr<DecodedProgram const> const D,
+    int const argc,
+    char* argv[],
+    std::size_t const memory_size_in_bytes,
+    std::unique_ptr<MemBlockAllocator> allocator
+    )
+    : decoded_program_{ D }
+    , program_{ &D->program() }
+    , pointer_model_{ make_pointer_model(*program_, allocator.get()) }
+    , allocator_{ allocator != nullptr ? std::move(allocator) : std::make_unique<MemBlockAllocatorHeap>() }
     , memory_size_in_bytes_{ memory_size_in_bytes }
 
     , stage_{ Stage::INITIALIZING }
@@ -84,68 +233,100 @@ ExecState::ExecState(Program const* const P, int const argc, char* argv[], std::
     , terminator_{}
     , error_message_{}
     , termination_instruction_{ nullptr }
-    , exit_code_{ pointer_model_, sizeof(std::uint64_t) }
-    , argc_{ argc }
-    , argv_{ pointer_model_, std::max(1, argc + 1) * pointer_model_->sizeof_pointer() }
+    , exit_code_{ allocator_.get(), pointer_model_, sizeof(std::uint64_t) }
+    , argc_{ 0 }
+    , argv_{}
     , argv_c_strings_{}
     , warnings_{}
 
+    , shares_constants_{ dynamic_cast<MemBlockAllocatorFlat*>(allocator_.get()) == nullptr }
     , constant_segment_{}
     , static_segment_{}
     , function_segment_{}
     , functions_at_addresses_{}
     , stack_segment_{}
-    , heap_segment_{}
+    , recycled_stack_records_{}
+    , heap_segment_{ pointer_model_, allocator_.get() }
+    , call_site_caches_(D->num_call_sites())
 
     , stack_exit_depth_{ 0ULL }
 
     , atexit_stack_{}
 
+    , operand_templates_{}
     , current_function_{ nullptr }
     , current_block_{ nullptr }
     , current_instruction_{ nullptr }
+    , current_decoded_instruction_{ nullptr }
     , current_operands_{}
+    , undecoded_operands_{}
 {
     static_assert(sizeof(int) == sizeof(std::int32_t));
-    ASSUMPTION(argc_ >= 0 && (argc_ == 0 || argv != nullptr));
 
-    std::memset(argv_.start(), 0, argv_.count());
-    argv_c_strings_.reserve(argc_);
-    for (int i = 0; i < argc_; ++i)
-    {
-        std::size_t const len{ std::strlen(argv[i]) + 1ULL };
-        argv_c_strings_.push_back(MemBlock{ pointer_model(), len });
-        std::memcpy(argv_c_strings_.back().start(), argv[i], len);
-        argv_.write_pointer_from_offset(i * pointer_model_->sizeof_pointer(), argv_c_strings_.back().start());
-    }
+    allocate_command_line(argc, argv);
 
-    ASSUMPTION((
-        memory_size_in_bytes == 0ULL ||
-        [this]() -> std::size_t {
-            std::size_t arg_bytes{ sizeof(int) + argc_ * pointer_model_->sizeof_pointer() };
-            for (MemBlock const& block : argv_c_strings_)
-                arg_bytes += block.count();
-            return arg_bytes;
-        }() <= memory_size_in_bytes
-    ));
-
-    for (auto const& constant : program().constants())
+    // The constants are shared with all states of the decoded program, except in the
+    // flat mode, where all memory must be inside the region.
+    if (shares_constants_)
     {
-        constant_segment_.push_back(MemBlock{ pointer_model(), constant.num_bytes() });
-        std::memcpy(constant_segment_.back().start(), constant.bytes().data(), constant.num_bytes());
+        std::vector<std::pair<MemPtr, std::size_t> > ranges;
+        ranges.reserve(program().constants().size());
+        for (std::size_t i = 0ULL; i != program().constants().size(); ++i)
+            ranges.push_back({
+                const_cast<MemPtr>(decoded_program().constant_bytes() + decoded_program().constant_offsets().at(i)),
+                program().constants().at(i).num_bytes()
+                });
+        constant_segment_.reserve(ranges.size());
+        MemBlock::push_back_views(allocator_.get(), pointer_model(), ranges, constant_segment_);
     }
+    else
+        for (auto const& constant : program().constants())
+        {
+            constant_segment_.push_back(MemBlock{ allocator_.get(), pointer_model(), constant.num_bytes() });
+            std::memcpy(constant_segment_.back().start(), constant.bytes().data(), constant.num_bytes());
+        }
 
     for (auto const& var : program().static_variables())
-        static_segment_.push_back(MemBlock{ pointer_model(), var.num_bytes(), 0 });
+        static_segment_.push_back(MemBlock{ allocator_.get(), pointer_model(), var.num_bytes(), 0 });
 
     for (auto const& func : program().functions())
     {
         ASSUMPTION((std::uint32_t)function_segment_.size() == func.index());
-        function_segment_.push_back(MemBlock{ pointer_model(), 1ULL });
+        function_segment_.push_back(MemBlock{ allocator_.get(), pointer_model(), 1ULL });
         functions_at_addresses_.insert({ function_segment_.back().start(), func.index() });
     }
 
-    stack_segment_.push_back(StackRecord(pointer_model(), program().functions().at(Program::static_initializer())));
+    operand_templates_.reserve(decoded_program().functions().size());
+    for (auto const& decoded_function : decoded_program().functions())
+    {
+        operand_templates_.push_back({});
+        for (auto const& operand : decoded_function.operands())
+        {
+            MemBlock const* block{ nullptr };
+            switch (operand.descriptor)
+            {
+            case Instruction::Descriptor::STATIC:
+                if (operand.index < static_segment().size())
+                    block = &static_segment()[operand.index];
+                break;
+            case Instruction::Descriptor::CONSTANT:
+                if (operand.index < constant_segment().size())
+                    block = &constant_segment()[operand.index];
+                break;
+            case Instruction::Descriptor::FUNCTION:
+                if (operand.index < function_segment().size())
+                    block = &function_segment()[operand.index];
+                break;
+            default: break;
+            }
+            operand_templates_.back().push_back(block);
+        }
+    }
+
+    if (memory_size_in_bytes_ == 0ULL)
+        recycled_stack_records_.resize(program().functions().size());
+
+    push_stack_record(program().functions().at(Program::static_initializer()));
 
     update_current_values();
 }
@@ -162,14 +343,293 @@ ExecState::~ExecState()
     function_segment_.clear();
     functions_at_addresses_.clear();
     stack_segment_.clear();
+    recycled_stack_records_.clear();
     heap_segment_.clear();
 
-    current_operands_.clear();
+    current_operands_ = {};
+    undecoded_operands_.clear();
+    operand_templates_.clear();
 
     delete pointer_model_;
 }
 
 
+void ExecState::allocate_command_line(int const argc, char* argv[])
+{
+    ASSUMPTION(argc >= 0 && (argc == 0 || argv != nullptr));
+
+    argc_ = argc;
+    argv_c_strings_.clear();
+    argv_ = MemBlock{ allocator_.get(), pointer_model_, std::max(1, argc + 1) * pointer_model_->sizeof_pointer() };
+    std::memset(argv_.start(), 0, argv_.count());
+    argv_c_strings_.reserve(argc_);
+    for (int i = 0; i < argc_; ++i)
+    {
+        std::size_t const len{ std::strlen(argv[i]) + 1ULL };
+        argv_c_strings_.push_back(MemBlock{ allocator_.get(), pointer_model(), len });
+        std::memcpy(argv_c_strings_.back().start(), argv[i], len);
+        argv_.write_pointer_from_offset(i * pointer_model_->sizeof_pointer(), argv_c_strings_.back().start());
+    }
+
+    ASSUMPTION((
+        memory_size_in_bytes_ == 0ULL ||
+        [this]() -> std::size_t {
+            std::size_t arg_bytes{ sizeof(int) + argc_ * pointer_model_->sizeof_pointer() };
+            for (MemBlock const& block : argv_c_strings_)
+                arg_bytes += block.count();
+            return arg_bytes;
+        }() <= memory_size_in_bytes_
+    ));
+}
+
+
+void ExecState::write_entry_function_parameters()
+{
+    auto const& params{ stack_top().parameters() };
+
+    if (params.empty())
+    {
+        // void main(void)
+        // => nothing to do.
+    }
+    else if (params.size() == 1ULL)
+    {
+        // int main(void)
+        ASSUMPTION(params.front().count() == pointer_model()->sizeof_pointer());
+        params.front().write(exit_code_memory_block().start());
+    }
+    else if (params.size() == 2ULL)
+    {
+        // void main(int argc, char* argv[])
+        ASSUMPTION(params.front().count() == sizeof(int));
+        ASSUMPTION(params.back().count() == pointer_model()->sizeof_pointer());
+        params.front().write(argc());
+        params.back().write(argv().start());
+    }
+    else
+    {
+        // int main(int argc, char* argv[])
+        ASSUMPTION(params.size() == 3ULL);
+        ASSUMPTION(params.front().count() == pointer_model()->sizeof_pointer());
+        ASSUMPTION(params.at(1ULL).count() == sizeof(int));
+        ASSUMPTION(params.back().count() == pointer_model()->sizeof_pointer());
+        params.front().write(exit_code_memory_block().start());
+        params.at(1ULL).write(argc());
+        params.back().write(argv().start());
+    }
+}
+
+
+void ExecState::set_command_line(int const argc, char* argv[])
+{
+    ASSUMPTION(
+        stage_ == Stage::INITIALIZING ||
+        (stage_ == Stage::EXECUTING &&
+            stack_segment_.size() == 1ULL &&
+            stack_top().function_index() == program().entry_function() &&
+            stack_top().ip().block() == 0U &&
+            stack_top().ip().instr() == 0U)
+        );
+
+    allocate_command_line(argc, argv);
+    if (stage_ == Stage::EXECUTING)
+        write_entry_function_parameters();
+}
+
+
+template<typename Visitor>
+void ExecState::for_each_memory_block(Visitor&& visitor) const
+{
+    visitor(exit_code_);
+    visitor(argv_);
+    for (MemBlock const& block : argv_c_strings_)
+        visitor(block);
+    if (!shares_constants_)
+        for (MemBlock const& block : constant_segment_)
+            visitor(block);
+    for (MemBlock const& block : static_segment_)
+        visitor(block);
+    for (StackRecord const& record : stack_segment_)
+    {
+        for (MemBlock const& block : record.parameters())
+            visitor(block);
+        for (MemBlock const& block : record.locals())
+            visitor(block);
+        for (MemBlock const& block : record.variadic_parameters())
+            visitor(block);
+    }
+    for (MemBlock const& block : heap_segment_)
+        visitor(block);
+}
+
+
+void ExecState::push_stack_record(Function const& F)
+{
+    if (has_recycled_stack_record(F.index()))
+    {
+        std::vector<StackRecord>& records{ recycled_stack_records_[F.index()] };
+        stack_segment_.push_back(std::move(records.back()));
+        records.pop_back();
+    }
+    else
+        stack_segment_.push_back(StackRecord(allocator_.get(), pointer_model(), F));
+}
+
+
+void ExecState::pop_stack_record()
+{
+    StackRecord record{ stack_segment_.pop_back() };
+    if (!recycled_stack_records_.empty() && record.reset(program().functions()[record.function_index()]))
+        recycled_stack_records_[record.function_index()].push_back(std::move(record));
+}
+
+
+void ExecState::release_recycled_stack_records()
+{
+    for (std::vector<StackRecord>& records : recycled_stack_records_)
+        records.clear();
+}
+
+
+ExecState::CallTarget const* ExecState::call_target(MemPtr const address)
+{
+    ASSUMPTION(current_decoded_instruction().call_site < call_site_caches_.size());
+    CallSiteCache& cache{ call_site_caches_[current_decoded_instruction().call_site] };
+    for (std::uint32_t i = 0U; i != cache.size; ++i)
+        if (cache.targets[i].address == address)
+            return &cache.targets[i];
+
+    auto const it{ functions_at_addresses_.find(address) };
+    if (it == functions_at_addresses_.end())
+        return nullptr;
+
+    std::uint32_t slot;
+    if (cache.size < CallSiteCache::capacity)
+        slot = cache.size++;
+    else
+    {
+        slot = cache.next;
+        cache.next = (cache.next + 1U) % (std::uint32_t)CallSiteCache::capacity;
+    }
+    cache.targets[slot] = { address, it->second };
+    return &cache.targets[slot];
+}
+
+
+ExecState::Snapshot ExecState::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.state_ = this;
+    snapshot.stage_ = stage_;
+    snapshot.termination_ = termination_;
+    snapshot.terminator_ = terminator_;
+    snapshot.error_message_ = error_message_;
+    snapshot.termination_instruction_ = termination_instruction_;
+    snapshot.warnings_ = warnings_;
+    snapshot.stack_segment_ = stack_segment_;
+    snapshot.heap_segment_.assign(heap_segment_.begin(), heap_segment_.end());
+    snapshot.stack_exit_depth_ = stack_exit_depth_;
+    snapshot.atexit_stack_ = atexit_stack_;
+
+    std::size_t num_bytes{ 0ULL };
+    for_each_memory_block([&snapshot, &num_bytes](MemBlock const& block) {
+        snapshot.blocks_.push_back(block);
+        num_bytes += block.count();
+    });
+    snapshot.offsets_.reserve(snapshot.blocks_.size());
+    snapshot.bytes_.resize(num_bytes);
+    std::size_t offset{ 0ULL };
+    for (MemBlock const& block : snapshot.blocks_)
+    {
+        snapshot.offsets_.push_back(offset);
+        std::memcpy(snapshot.bytes_.data() + offset, block.start(), block.count());
+        offset += block.count();
+    }
+
+    // The operand tables point to blocks of the records of the state.
+    for (StackRecord& record : snapshot.stack_segment_)
+        record.operand_table().clear();
+
+    snapshot.tracking_epoch_ = 0ULL;
+    auto const flat{ dynamic_cast<MemBlockAllocatorFlat*>(allocator_.get()) };
+    if (flat != nullptr && flat->track_writes())
+    {
+        snapshot.tracking_epoch_ = flat->tracking_epoch();
+        std::size_t const page_bytes{ flat->tracking_page_bytes() };
+        std::size_t const num_pages{ (std::size_t)(flat->tracked_end() - flat->begin()) / page_bytes };
+        auto const for_each_page = [flat, page_bytes](MemBlock const& block, auto&& callback) {
+            if (block.count() == 0ULL)
+                return;
+            std::size_t const first{ (std::size_t)(block.start() - flat->begin()) / page_bytes };
+            std::size_t const last{ (std::size_t)(block.start() + block.count() - 1ULL - flat->begin()) / page_bytes };
+            for (std::size_t page = first; page <= last; ++page)
+                callback(page);
+        };
+        snapshot.page_begins_.assign(num_pages + 1ULL, 0U);
+        for (MemBlock const& block : snapshot.blocks_)
+            for_each_page(block, [&snapshot](std::size_t const page) { ++snapshot.page_begins_.at(page + 1ULL); });
+        for (std::size_t page = 0ULL; page != num_pages; ++page)
+            snapshot.page_begins_.at(page + 1ULL) += snapshot.page_begins_.at(page);
+        snapshot.page_blocks_.resize(snapshot.page_begins_.back());
+        std::vector<std::uint32_t> cursors{ snapshot.page_begins_.begin(), snapshot.page_begins_.end() - 1 };
+        for (std::uint32_t i = 0U; i != (std::uint32_t)snapshot.blocks_.size(); ++i)
+            for_each_page(snapshot.blocks_.at(i), [&snapshot, &cursors, i](std::size_t const page) {
+                snapshot.page_blocks_.at(cursors.at(page)++) = i;
+            });
+    }
+
+    return snapshot;
+}
+
+
+void ExecState::restore(Snapshot const& snapshot)
+{
+    ASSUMPTION(snapshot.state_ == this);
+
+    stage_ = snapshot.stage_;
+    termination_ = snapshot.termination_;
+    terminator_ = snapshot.terminator_;
+    error_message_ = snapshot.error_message_;
+    termination_instruction_ = snapshot.termination_instruction_;
+    warnings_ = snapshot.warnings_;
+    stack_segment_ = snapshot.stack_segment_;
+    // The recycled records may share memory with the records of the snapshot.
+    release_recycled_stack_records();
+    heap_segment_.assign(snapshot.heap_segment_);
+    stack_exit_depth_ = snapshot.stack_exit_depth_;
+    atexit_stack_ = snapshot.atexit_stack_;
+
+    auto const flat{ dynamic_cast<MemBlockAllocatorFlat*>(allocator_.get()) };
+    if (flat != nullptr && snapshot.tracking_epoch_ != 0ULL && flat->tracking_epoch() == snapshot.tracking_epoch_)
+    {
+        std::size_t const page_bytes{ flat->tracking_page_bytes() };
+        for (std::size_t i = 0ULL; i != flat->num_dirty_pages(); ++i)
+        {
+            MemPtr const page_begin{ flat->dirty_page(i) };
+            std::size_t const page{ (std::size_t)(page_begin - flat->begin()) / page_bytes };
+            if (page + 1ULL >= snapshot.page_begins_.size())
+                continue;
+            for (std::uint32_t j = snapshot.page_begins_.at(page); j != snapshot.page_begins_.at(page + 1ULL); ++j)
+            {
+                std::uint32_t const k{ snapshot.page_blocks_.at(j) };
+                MemBlock const& block{ snapshot.blocks_.at(k) };
+                MemPtr const begin{ std::max(block.start(), page_begin) };
+                MemPtr const end{ std::min(block.start() + block.count(), page_begin + page_bytes) };
+                std::memcpy(begin, snapshot.bytes_.data() + snapshot.offsets_.at(k) + (begin - block.start()), end - begin);
+            }
+        }
+        flat->protect_dirty_pages();
+    }
+    else
+        for (std::size_t i = 0ULL; i != snapshot.blocks_.size(); ++i)
+            std::memcpy(snapshot.blocks_.at(i).start(), snapshot.bytes_.data() + snapshot.offsets_.at(i), snapshot.blocks_.at(i).count());
+
+    current_operands_ = {};
+    if (!stack_segment_.empty())
+        update_current_values();
+}
+
+
 std::string  ExecState::report(std::string const&  error_message_suffix) const
 {
     std::stringstream  sstr;
@@ -215,36 +675,97 @@ bool ExecState::set_termination(
 }
 
 
-void ExecState::update_current_values()
+void ExecState::build_operand_table(StackRecord& record, DecodedFunction const& decoded_function) const
 {
-    current_function_ = &program().functions().at(stack_top().function_index());
-    current_block_ = &current_function_->basic_blocks().at(stack_top().ip().block());
-    current_instruction_ = &current_block_->instructions().at(stack_top().ip().instr());
+    auto& table{ record.operand_table() };
+    table = operand_templates_.at(record.function_index());
+    for (std::size_t i = 0ULL, n = table.size(); i != n; ++i)
+    {
+        auto const& operand{ decoded_function.operands()[i] };
+        switch (operand.descriptor)
+        {
+        case Instruction::Descriptor::LOCAL:
+            if (operand.index < record.locals().size())
+                table[i] = &record.locals()[operand.index];
+            break;
+        case Instruction::Descriptor::PARAMETER:
+            if (operand.index < record.parameters().size())
+                table[i] = &record.parameters()[operand.index];
+            break;
+        default: break;
+        }
+    }
+}
 
-    current_operands_.clear();
+
+void ExecState::update_undecoded_operands()
+{
+    undecoded_operands_.clear();
     for (std::uint32_t i = 0U, n = (std::uint32_t)current_instruction_->operands().size(); i < n; ++i)
     {
         auto const idx{ current_instruction_->operands().at(i) };
         switch (current_instruction_->descriptors().at(i))
         {
         case Instruction::Descriptor::STATIC:
-            current_operands_.push_back(&static_segment().at(idx));
+            undecoded_operands_.push_back(&static_segment().at(idx));
             break;
         case Instruction::Descriptor::LOCAL:
-            current_operands_.push_back(&stack_top().locals().at(idx));
+            undecoded_operands_.push_back(&stack_top().locals().at(idx));
             break;
         case Instruction::Descriptor::PARAMETER:
-            current_operands_.push_back(&stack_top().parameters().at(idx));
+            undecoded_operands_.push_back(&stack_top().parameters().at(idx));
             break;
         case Instruction::Descriptor::CONSTANT:
-            current_operands_.push_back(&constant_segment().at(idx));
+            undecoded_operands_.push_back(&constant_segment().at(idx));
             break;
         case Instruction::Descriptor::FUNCTION:
-            current_operands_.push_back(&function_segment().at(idx));
+            undecoded_operands_.push_back(&function_segment().at(idx));
             break;
         default: UNREACHABLE(); break;
         }
     }
+    current_operands_ = { undecoded_operands_.data(), undecoded_operands_.data() + undecoded_operands_.size() };
+}
+
+
+void ExecState::update_current_values_to_next_instruction()
+{
+    ++current_decoded_instruction_;
+    current_instruction_ = current_decoded_instruction_->instruction;
+
+    if (current_decoded_instruction_->handler == nullptr || stack_top().operand_table().empty())
+    {
+        update_current_values();
+        return;
+    }
+
+    MemBlock const* const* const table{ stack_top().operand_table().data() };
+    current_operands_ = { table + current_decoded_instruction_->operands_begin, table + current_decoded_instruction_->operands_end };
+}
+
+
+void ExecState::update_current_values()
+{
+    StackRecord& record{ stack_top() };
+    DecodedFunction const& decoded_function{ decoded_program().function(record.function_index()) };
+
+    current_decoded_instruction_ = &decoded_function.instruction(record.ip().block(), record.ip().instr());
+    current_function_ = &decoded_function.function();
+    current_block_ = &current_function_->basic_blocks()[record.ip().block()];
+    current_instruction_ = current_decoded_instruction_->instruction;
+
+    if (current_decoded_instruction_->handler == nullptr)
+    {
+        // The instruction is not valid, so we resolve operands the slow way.
+        update_undecoded_operands();
+        return;
+    }
+
+    if (record.operand_table().size() != decoded_function.operands().size())
+        build_operand_table(record, decoded_function);
+
+    MemBlock const* const* const table{ record.operand_table().data() };
+    current_operands_ = { table + current_decoded_instruction_->operands_begin, table + current_decoded_instruction_->operands_end };
 }
 
 
@@ -4,6 +4,7 @@
 #include <cstring>
 #include <cmath>
 #include <cfenv>
+#include <mutex>
 #include <unistd.h>
 #include <getopt.h>
 
@@ -307,6 +308,41 @@ void ExternCodeCStd::strncmp_impl()
 }
 
 
+static std::mutex getopt_mutex;
+static ExternCodeCStd const* getopt_owner{ nullptr };
+
+
+void ExternCodeCStd::begin_getopt(int const argc, char* const argv[], char const* const opt_string)
+{
+    if (getopt_owner == this && getopt_optind_ != 0)
+        return;
+    getopt_owner = this;
+    optind = 0;
+    if (getopt_optind_ == 0)
+        return;
+    int const saved_opterr{ opterr };
+    opterr = 0;
+    // The call with no arguments only reinitializes the host state, which clears
+    // the position inside a group of short options of the previous owner.
+    char arg0[] = "";
+    char* empty_argv[] = { arg0, nullptr };
+    getopt(1, empty_argv, "");
+    optind = getopt_optind_;
+    for (int i = 0; i != getopt_group_position_; ++i)
+        getopt(argc, argv, opt_string);
+    opterr = saved_opterr;
+}
+
+
+void ExternCodeCStd::end_getopt(int const result)
+{
+    // The first call initializes 'optind' to 1.
+    int const previous_optind{ getopt_optind_ != 0 ? getopt_optind_ : 1 };
+    getopt_group_position_ = result != -1 && optind == previous_optind ? getopt_group_position_ + 1 : 0;
+    getopt_optind_ = optind;
+}
+
+
 void ExternCodeCStd::getopt_impl()
 {
     auto const argc{ parameters().at(1).read<int>() };
@@ -334,7 +370,10 @@ void ExternCodeCStd::getopt_impl()
         return;
     }
     auto const dst_ptr{ parameters().front().read<int*>() };
+    std::lock_guard<std::mutex> const lock{ getopt_mutex };
+    begin_getopt(argc, argv, opt_string);
     *dst_ptr = getopt(argc, argv, opt_string);
+    end_getopt(*dst_ptr);
 }
 
 
@@ -387,7 +426,10 @@ void ExternCodeCStd::getopt_long_impl()
         return;
     }
     auto const dst_ptr{ parameters().front().read<int*>() };
+    std::lock_guard<std::mutex> const lock{ getopt_mutex };
+    begin_getopt(argc, argv, opt_string);
     *dst_ptr = getopt_long(argc, argv, opt_string, longopts, longindex);
+    end_getopt(*dst_ptr);
 }
 
 
@@ -0,0 +1,171 @@
+#include <sala/heap.hpp>
+
+namespace sala {
+
+
+Heap::Slots::Slots(MemBlockAllocator* const backing)
+    : backing_{ backing }
+    , free_slots_{}
+    , chunks_{}
+    , cursors_{}
+    , ends_{}
+{
+    free_slots_.fill(nullptr);
+    cursors_.fill(nullptr);
+    ends_.fill(nullptr);
+}
+
+
+Heap::Slots::~Slots()
+{
+    for (std::uintptr_t const chunk : chunks_)
+        backing_->deallocate_chunk((void*)chunk, chunk_bytes);
+}
+
+
+std::size_t Heap::Slots::size_class(std::size_t const num_slot_bytes)
+{
+    std::size_t idx{ 0ULL };
+    while (slot_bytes(idx) < num_slot_bytes)
+        ++idx;
+    return idx;
+}
+
+
+bool Heap::Slots::in_chunk(MemPtr const ptr) const
+{
+    return chunks_.count((std::uintptr_t)ptr & ~(chunk_bytes - 1ULL)) != 0ULL;
+}
+
+
+void* Heap::Slots::allocate(std::size_t const num_bytes)
+{
+    std::size_t const num_slot_bytes{ num_bytes + header_bytes };
+    SlotHeader* header;
+    if (num_slot_bytes > slot_bytes(num_size_classes - 1ULL))
+        header = (SlotHeader*)backing_->allocate(num_slot_bytes);
+    else
+    {
+        std::size_t const idx{ size_class(num_slot_bytes) };
+        if (free_slots_.at(idx) != nullptr)
+        {
+            header = free_slots_.at(idx);
+            free_slots_.at(idx) = header->next_free;
+        }
+        else
+        {
+            if (cursors_.at(idx) == ends_.at(idx))
+            {
+                void* const chunk{ backing_->allocate_chunk(chunk_bytes) };
+                chunks_.insert((std::uintptr_t)chunk);
+                cursors_.at(idx) = (std::uint8_t*)chunk;
+                ends_.at(idx) = cursors_.at(idx) + chunk_bytes;
+            }
+            header = (SlotHeader*)cursors_.at(idx);
+            cursors_.at(idx) += slot_bytes(idx);
+        }
+    }
+    header->index = no_index;
+    header->next_free = nullptr;
+    return (std::uint8_t*)header + header_bytes;
+}
+
+
+void Heap::Slots::deallocate(void* const ptr, std::size_t const num_bytes)
+{
+    std::size_t const num_slot_bytes{ num_bytes + header_bytes };
+    SlotHeader* const header{ (SlotHeader*)((std::uint8_t*)ptr - header_bytes) };
+    if (num_slot_bytes > slot_bytes(num_size_classes - 1ULL))
+    {
+        backing_->deallocate(header, num_slot_bytes);
+        return;
+    }
+    std::size_t const idx{ size_class(num_slot_bytes) };
+    header->index = no_index;
+    header->next_free = free_slots_.at(idx);
+    free_slots_.at(idx) = header;
+}
+
+
+Heap::Heap(PointerModel* const pointer_model, MemBlockAllocator* const backing)
+    : pointer_model_{ pointer_model }
+    , slots_{ backing }
+    , blocks_{}
+    , large_blocks_{}
+{}
+
+
+Heap::~Heap()
+{
+    clear();
+}
+
+
+MemBlock const* Heap::find(MemPtr const ptr) const
+{
+    if (ptr == nullptr || (std::uintptr_t)ptr % MemBlockAllocator::alignment != 0ULL)
+        return nullptr;
+    if (slots_.in_chunk(ptr))
+    {
+        std::uintptr_t const chunk{ (std::uintptr_t)ptr & ~(Slots::chunk_bytes - 1ULL) };
+        if ((std::uintptr_t)ptr - chunk < detail::memblock_bytes_offset + Slots::header_bytes)
+            return nullptr;
+    }
+    else if (large_blocks_.count(ptr) == 0ULL)
+        return nullptr;
+    std::size_t const index{ header_of(ptr)->index };
+    if (index >= blocks_.size() || blocks_.at(index).start() != ptr)
+        return nullptr;
+    return &blocks_.at(index);
+}
+
+
+MemBlock const& Heap::allocate(std::size_t const num_bytes)
+{
+    MemBlock block{ &slots_, pointer_model_, num_bytes };
+    if (!slots_.in_chunk(block.start()))
+        large_blocks_.insert(block.start());
+    header_of(block.start())->index = blocks_.size();
+    blocks_.push_back(std::move(block));
+    return blocks_.back();
+}
+
+
+bool Heap::release(MemPtr const ptr)
+{
+    MemBlock const* const block{ find(ptr) };
+    if (block == nullptr)
+        return false;
+    std::size_t const index{ header_of(ptr)->index };
+    large_blocks_.erase(ptr);
+    if (index + 1ULL != blocks_.size())
+    {
+        blocks_.at(index) = std::move(blocks_.back());
+        header_of(blocks_.at(index).start())->index = index;
+    }
+    blocks_.pop_back();
+    return true;
+}
+
+
+void Heap::clear()
+{
+    blocks_.clear();
+    large_blocks_.clear();
+}
+
+
+void Heap::assign(std::vector<MemBlock> const& blocks)
+{
+    clear();
+    blocks_ = blocks;
+    for (std::size_t i = 0ULL; i != blocks_.size(); ++i)
+    {
+        if (!slots_.in_chunk(blocks_.at(i).start()))
+            large_blocks_.insert(blocks_.at(i).start());
+        header_of(blocks_.at(i).start())->index = i;
+    }
+}
+
+
+}
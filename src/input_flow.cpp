@@ -307,9 +307,9 @@ void InputFlow::do_moveptr()
 void InputFlow::do_free()
 {
     MemPtr ptr{ operands().front()->read<MemPtr>() };
-    auto const it = state().heap_segment().find(ptr);
-    if (it != state().heap_segment().end())
-        clear(ptr, it->second.count());
+    MemBlock const* const block{ state().heap_segment().find(ptr) };
+    if (block != nullptr)
+        clear(ptr, block->count());
 }
 
 
@@ -1555,7 +1555,9 @@ void InputFlow::do_va_copy()
 
 void InputFlow::do_call()
 {
-    std::vector<MemBlock const*> const ops{ operands() };
+    // The operands view still refers to the operand table of the caller's stack record,
+    // which keeps its place in memory, when the interpreter pushes the callee's record.
+    Operands const ops{ operands() };
     set_post_operation([this, ops]() {
         std::uint32_t idx = 1U;
         auto const& params = stack_top().parameters();
@@ -1,4 +1,5 @@
 #include <sala/instr_switch.hpp>
+#include <sala/decoded_program.hpp>
 #include <utility/invariants.hpp>
 #include <utility/development.hpp>
 
@@ -7,757 +8,798 @@ namespace sala {
 
 bool InstrSwitch::do_instruction_switch()
 {
-    switch (instruction().opcode())
+    Handler const handler{ decode(
+            instruction(),
+            operands().empty() ? 0ULL : operands().front()->count(),
+            operands().empty() ? 0ULL : operands().back()->count()
+            ) };
+    if (handler == nullptr)
     {
-        case Instruction::Opcode::NOP: do_nop(); return false;
+        UNREACHABLE();
+        return false;
+    }
+    (this->*handler)();
+    return transfers_control(instruction().opcode());
+}
+
+
+bool InstrSwitch::do_instruction_switch(DecodedInstruction const& decoded)
+{
+    if (decoded.handler == nullptr)
+        return do_instruction_switch();
+    (this->*decoded.handler)();
+    return decoded.transfers_control;
+}
+
+
+bool InstrSwitch::transfers_control(Instruction::Opcode const opcode)
+{
+    switch (opcode)
+    {
+        case Instruction::Opcode::JUMP:
+        case Instruction::Opcode::BRANCH:
+        case Instruction::Opcode::CALL:
+        case Instruction::Opcode::RET:
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+InstrSwitch::Handler InstrSwitch::decode(Instruction const& instruction, std::size_t const front_count, std::size_t const back_count)
+{
+    switch (instruction.opcode())
+    {
+        case Instruction::Opcode::NOP: return &InstrSwitch::do_nop;
 
-        case Instruction::Opcode::HALT: do_halt(); return false;
+        case Instruction::Opcode::HALT: return &InstrSwitch::do_halt;
 
-        case Instruction::Opcode::ADDRESS: do_address(); return false;
-        case Instruction::Opcode::LOAD: do_load(); return false;
-        case Instruction::Opcode::STORE: do_store(); return false;
+        case Instruction::Opcode::ADDRESS: return &InstrSwitch::do_address;
+        case Instruction::Opcode::LOAD: return &InstrSwitch::do_load;
+        case Instruction::Opcode::STORE: return &InstrSwitch::do_store;
 
         case Instruction::Opcode::COPY:
-            switch (operands().front()->count())
+            switch (front_count)
             {
-            case 1ULL: do_copy_8(); return false;
-            case 2ULL: do_copy_16(); return false;
-            case 4ULL: do_copy_32(); return false;
-            case 8ULL: do_copy_64(); return false;
-            default: do_copy(); return false;
+            case 1ULL: return &InstrSwitch::do_copy_8;
+            case 2ULL: return &InstrSwitch::do_copy_16;
+            case 4ULL: return &InstrSwitch::do_copy_32;
+            case 8ULL: return &InstrSwitch::do_copy_64;
+            default: return &InstrSwitch::do_copy;
             }
 
-        case Instruction::Opcode::MEMCPY: do_memcpy(); return false;
-        case Instruction::Opcode::MEMMOVE: do_memmove(); return false;
-        case Instruction::Opcode::MEMSET: do_memset(); return false;
-        case Instruction::Opcode::MOVEPTR: do_moveptr(); return false;
+        case Instruction::Opcode::MEMCPY: return &InstrSwitch::do_memcpy;
+        case Instruction::Opcode::MEMMOVE: return &InstrSwitch::do_memmove;
+        case Instruction::Opcode::MEMSET: return &InstrSwitch::do_memset;
+        case Instruction::Opcode::MOVEPTR: return &InstrSwitch::do_moveptr;
 
-        case Instruction::Opcode::ALLOCA: do_alloca(); return false;
-        case Instruction::Opcode::STACKSAVE: do_stacksave(); return false;
-        case Instruction::Opcode::STACKRESTORE: do_stackrestore(); return false;
-        case Instruction::Opcode::MALLOC: do_malloc(); return false;
-        case Instruction::Opcode::FREE: do_free(); return false;
+        case Instruction::Opcode::ALLOCA: return &InstrSwitch::do_alloca;
+        case Instruction::Opcode::STACKSAVE: return &InstrSwitch::do_stacksave;
+        case Instruction::Opcode::STACKRESTORE: return &InstrSwitch::do_stackrestore;
+        case Instruction::Opcode::MALLOC: return &InstrSwitch::do_malloc;
+        case Instruction::Opcode::FREE: return &InstrSwitch::do_free;
 
         case Instruction::Opcode::ADD:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_add_s8(); return false;
-                case 2ULL: do_add_s16(); return false;
-                case 4ULL: do_add_s32(); return false;
-                case 8ULL: do_add_s64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_add_s8;
+                case 2ULL: return &InstrSwitch::do_add_s16;
+                case 4ULL: return &InstrSwitch::do_add_s32;
+                case 8ULL: return &InstrSwitch::do_add_s64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_add_u8(); return false;
-                case 2ULL: do_add_u16(); return false;
-                case 4ULL: do_add_u32(); return false;
-                case 8ULL: do_add_u64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_add_u8;
+                case 2ULL: return &InstrSwitch::do_add_u16;
+                case 4ULL: return &InstrSwitch::do_add_u32;
+                case 8ULL: return &InstrSwitch::do_add_u64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 4ULL: do_add_f32(); return false;
-                case 8ULL: do_add_f64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_add_f32;
+                case 8ULL: return &InstrSwitch::do_add_f64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
     
         case Instruction::Opcode::SUB:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_sub_s8(); return false;
-                case 2ULL: do_sub_s16(); return false;
-                case 4ULL: do_sub_s32(); return false;
-                case 8ULL: do_sub_s64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_sub_s8;
+                case 2ULL: return &InstrSwitch::do_sub_s16;
+                case 4ULL: return &InstrSwitch::do_sub_s32;
+                case 8ULL: return &InstrSwitch::do_sub_s64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_sub_u8(); return false;
-                case 2ULL: do_sub_u16(); return false;
-                case 4ULL: do_sub_u32(); return false;
-                case 8ULL: do_sub_u64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_sub_u8;
+                case 2ULL: return &InstrSwitch::do_sub_u16;
+                case 4ULL: return &InstrSwitch::do_sub_u32;
+                case 8ULL: return &InstrSwitch::do_sub_u64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 4ULL: do_sub_f32(); return false;
-                case 8ULL: do_sub_f64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_sub_f32;
+                case 8ULL: return &InstrSwitch::do_sub_f64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::MUL:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_mul_s8(); return false;
-                case 2ULL: do_mul_s16(); return false;
-                case 4ULL: do_mul_s32(); return false;
-                case 8ULL: do_mul_s64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_mul_s8;
+                case 2ULL: return &InstrSwitch::do_mul_s16;
+                case 4ULL: return &InstrSwitch::do_mul_s32;
+                case 8ULL: return &InstrSwitch::do_mul_s64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_mul_u8(); return false;
-                case 2ULL: do_mul_u16(); return false;
-                case 4ULL: do_mul_u32(); return false;
-                case 8ULL: do_mul_u64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_mul_u8;
+                case 2ULL: return &InstrSwitch::do_mul_u16;
+                case 4ULL: return &InstrSwitch::do_mul_u32;
+                case 8ULL: return &InstrSwitch::do_mul_u64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 4ULL: do_mul_f32(); return false;
-                case 8ULL: do_mul_f64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_mul_f32;
+                case 8ULL: return &InstrSwitch::do_mul_f64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::DIV:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_div_s8(); return false;
-                case 2ULL: do_div_s16(); return false;
-                case 4ULL: do_div_s32(); return false;
-                case 8ULL: do_div_s64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_div_s8;
+                case 2ULL: return &InstrSwitch::do_div_s16;
+                case 4ULL: return &InstrSwitch::do_div_s32;
+                case 8ULL: return &InstrSwitch::do_div_s64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_div_u8(); return false;
-                case 2ULL: do_div_u16(); return false;
-                case 4ULL: do_div_u32(); return false;
-                case 8ULL: do_div_u64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_div_u8;
+                case 2ULL: return &InstrSwitch::do_div_u16;
+                case 4ULL: return &InstrSwitch::do_div_u32;
+                case 8ULL: return &InstrSwitch::do_div_u64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 4ULL: do_div_f32(); return false;
-                case 8ULL: do_div_f64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_div_f32;
+                case 8ULL: return &InstrSwitch::do_div_f64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::REM:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_rem_s8(); return false;
-                case 2ULL: do_rem_s16(); return false;
-                case 4ULL: do_rem_s32(); return false;
-                case 8ULL: do_rem_s64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_rem_s8;
+                case 2ULL: return &InstrSwitch::do_rem_s16;
+                case 4ULL: return &InstrSwitch::do_rem_s32;
+                case 8ULL: return &InstrSwitch::do_rem_s64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_rem_u8(); return false;
-                case 2ULL: do_rem_u16(); return false;
-                case 4ULL: do_rem_u32(); return false;
-                case 8ULL: do_rem_u64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_rem_u8;
+                case 2ULL: return &InstrSwitch::do_rem_u16;
+                case 4ULL: return &InstrSwitch::do_rem_u32;
+                case 8ULL: return &InstrSwitch::do_rem_u64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::AND:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::NONE:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_and_8(); return false;
-                case 2ULL: do_and_16(); return false;
-                case 4ULL: do_and_32(); return false;
-                case 8ULL: do_and_64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_and_8;
+                case 2ULL: return &InstrSwitch::do_and_16;
+                case 4ULL: return &InstrSwitch::do_and_32;
+                case 8ULL: return &InstrSwitch::do_and_64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::OR:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::NONE:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_or_8(); return false;
-                case 2ULL: do_or_16(); return false;
-                case 4ULL: do_or_32(); return false;
-                case 8ULL: do_or_64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_or_8;
+                case 2ULL: return &InstrSwitch::do_or_16;
+                case 4ULL: return &InstrSwitch::do_or_32;
+                case 8ULL: return &InstrSwitch::do_or_64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::XOR:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::NONE:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_xor_8(); return false;
-                case 2ULL: do_xor_16(); return false;
-                case 4ULL: do_xor_32(); return false;
-                case 8ULL: do_xor_64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_xor_8;
+                case 2ULL: return &InstrSwitch::do_xor_16;
+                case 4ULL: return &InstrSwitch::do_xor_32;
+                case 8ULL: return &InstrSwitch::do_xor_64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::SHL:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::NONE:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_shl_8(); return false;
-                case 2ULL: do_shl_16(); return false;
-                case 4ULL: do_shl_32(); return false;
-                case 8ULL: do_shl_64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_shl_8;
+                case 2ULL: return &InstrSwitch::do_shl_16;
+                case 4ULL: return &InstrSwitch::do_shl_32;
+                case 8ULL: return &InstrSwitch::do_shl_64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::SHR:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_shr_s8(); return false;
-                case 2ULL: do_shr_s16(); return false;
-                case 4ULL: do_shr_s32(); return false;
-                case 8ULL: do_shr_s64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_shr_s8;
+                case 2ULL: return &InstrSwitch::do_shr_s16;
+                case 4ULL: return &InstrSwitch::do_shr_s32;
+                case 8ULL: return &InstrSwitch::do_shr_s64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_shr_u8(); return false;
-                case 2ULL: do_shr_u16(); return false;
-                case 4ULL: do_shr_u32(); return false;
-                case 8ULL: do_shr_u64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_shr_u8;
+                case 2ULL: return &InstrSwitch::do_shr_u16;
+                case 4ULL: return &InstrSwitch::do_shr_u32;
+                case 8ULL: return &InstrSwitch::do_shr_u64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::NEG:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::FLOATING:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 4ULL: do_neg_f32(); return false;
-                case 8ULL: do_neg_f64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_neg_f32;
+                case 8ULL: return &InstrSwitch::do_neg_f64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::EXTEND:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
                 case 1ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 2ULL: do_extend_s8_s16(); return false;
-                    case 4ULL: do_extend_s8_s32(); return false;
-                    case 8ULL: do_extend_s8_s64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 2ULL: return &InstrSwitch::do_extend_s8_s16;
+                    case 4ULL: return &InstrSwitch::do_extend_s8_s32;
+                    case 8ULL: return &InstrSwitch::do_extend_s8_s64;
+                    default: return nullptr;
                     }
                 case 2ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 4ULL: do_extend_s16_s32(); return false;
-                    case 8ULL: do_extend_s16_s64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 4ULL: return &InstrSwitch::do_extend_s16_s32;
+                    case 8ULL: return &InstrSwitch::do_extend_s16_s64;
+                    default: return nullptr;
                     }
                 case 4ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 8ULL: do_extend_s32_s64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 8ULL: return &InstrSwitch::do_extend_s32_s64;
+                    default: return nullptr;
                     }
-                default: UNREACHABLE(); return false;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
                 case 1ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 2ULL: do_extend_u8_u16(); return false;
-                    case 4ULL: do_extend_u8_u32(); return false;
-                    case 8ULL: do_extend_u8_u64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 2ULL: return &InstrSwitch::do_extend_u8_u16;
+                    case 4ULL: return &InstrSwitch::do_extend_u8_u32;
+                    case 8ULL: return &InstrSwitch::do_extend_u8_u64;
+                    default: return nullptr;
                     }
                 case 2ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 4ULL: do_extend_u16_u32(); return false;
-                    case 8ULL: do_extend_u16_u64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 4ULL: return &InstrSwitch::do_extend_u16_u32;
+                    case 8ULL: return &InstrSwitch::do_extend_u16_u64;
+                    default: return nullptr;
                     }
                 case 4ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 8ULL: do_extend_u32_u64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 8ULL: return &InstrSwitch::do_extend_u32_u64;
+                    default: return nullptr;
                     }
-                default: UNREACHABLE(); return false;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
                 case 4ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 8ULL: do_extend_f32_f64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 8ULL: return &InstrSwitch::do_extend_f32_f64;
+                    default: return nullptr;
                     }
-                default: UNREACHABLE(); return false;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::TRUNCATE:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
                 case 2ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 1ULL: do_truncate_u16_u8(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 1ULL: return &InstrSwitch::do_truncate_u16_u8;
+                    default: return nullptr;
                     }
                 case 4ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 1ULL: do_truncate_u32_u8(); return false;
-                    case 2ULL: do_truncate_u32_u16(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 1ULL: return &InstrSwitch::do_truncate_u32_u8;
+                    case 2ULL: return &InstrSwitch::do_truncate_u32_u16;
+                    default: return nullptr;
                     }
                 case 8ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 1ULL: do_truncate_u64_u8(); return false;
-                    case 2ULL: do_truncate_u64_u16(); return false;
-                    case 4ULL: do_truncate_u64_u32(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 1ULL: return &InstrSwitch::do_truncate_u64_u8;
+                    case 2ULL: return &InstrSwitch::do_truncate_u64_u16;
+                    case 4ULL: return &InstrSwitch::do_truncate_u64_u32;
+                    default: return nullptr;
                     }
-                default: UNREACHABLE(); return false;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
                 case 8ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 4ULL: do_truncate_f64_f32(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 4ULL: return &InstrSwitch::do_truncate_f64_f32;
+                    default: return nullptr;
                     }
-                default: UNREACHABLE(); return false;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::F2I:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
                 case 4ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 1ULL: do_f2i_f32_s8(); return false;
-                    case 2ULL: do_f2i_f32_s16(); return false;
-                    case 4ULL: do_f2i_f32_s32(); return false;
-                    case 8ULL: do_f2i_f32_s64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 1ULL: return &InstrSwitch::do_f2i_f32_s8;
+                    case 2ULL: return &InstrSwitch::do_f2i_f32_s16;
+                    case 4ULL: return &InstrSwitch::do_f2i_f32_s32;
+                    case 8ULL: return &InstrSwitch::do_f2i_f32_s64;
+                    default: return nullptr;
                     }
                 case 8ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 1ULL: do_f2i_f64_s8(); return false;
-                    case 2ULL: do_f2i_f64_s16(); return false;
-                    case 4ULL: do_f2i_f64_s32(); return false;
-                    case 8ULL: do_f2i_f64_s64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 1ULL: return &InstrSwitch::do_f2i_f64_s8;
+                    case 2ULL: return &InstrSwitch::do_f2i_f64_s16;
+                    case 4ULL: return &InstrSwitch::do_f2i_f64_s32;
+                    case 8ULL: return &InstrSwitch::do_f2i_f64_s64;
+                    default: return nullptr;
                     }
-                default: UNREACHABLE(); return false;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
                 case 4ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 1ULL: do_f2i_f32_u8(); return false;
-                    case 2ULL: do_f2i_f32_u16(); return false;
-                    case 4ULL: do_f2i_f32_u32(); return false;
-                    case 8ULL: do_f2i_f32_u64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 1ULL: return &InstrSwitch::do_f2i_f32_u8;
+                    case 2ULL: return &InstrSwitch::do_f2i_f32_u16;
+                    case 4ULL: return &InstrSwitch::do_f2i_f32_u32;
+                    case 8ULL: return &InstrSwitch::do_f2i_f32_u64;
+                    default: return nullptr;
                     }
                 case 8ULL:
-                    switch (operands().front()->count())
+                    switch (front_count)
                     {
-                    case 1ULL: do_f2i_f64_u8(); return false;
-                    case 2ULL: do_f2i_f64_u16(); return false;
-                    case 4ULL: do_f2i_f64_u32(); return false;
-                    case 8ULL: do_f2i_f64_u64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 1ULL: return &InstrSwitch::do_f2i_f64_u8;
+                    case 2ULL: return &InstrSwitch::do_f2i_f64_u16;
+                    case 4ULL: return &InstrSwitch::do_f2i_f64_u32;
+                    case 8ULL: return &InstrSwitch::do_f2i_f64_u64;
+                    default: return nullptr;
                     }
-                default: UNREACHABLE(); return false;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::I2F:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
                 case 4ULL:
-                    switch (operands().back()->count())
+                    switch (back_count)
                     {
-                    case 1ULL: do_i2f_s8_f32(); return false;
-                    case 2ULL: do_i2f_s16_f32(); return false;
-                    case 4ULL: do_i2f_s32_f32(); return false;
-                    case 8ULL: do_i2f_s64_f32(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 1ULL: return &InstrSwitch::do_i2f_s8_f32;
+                    case 2ULL: return &InstrSwitch::do_i2f_s16_f32;
+                    case 4ULL: return &InstrSwitch::do_i2f_s32_f32;
+                    case 8ULL: return &InstrSwitch::do_i2f_s64_f32;
+                    default: return nullptr;
                     }
                 case 8ULL:
-                    switch (operands().back()->count())
+                    switch (back_count)
                     {
-                    case 1ULL: do_i2f_s8_f64(); return false;
-                    case 2ULL: do_i2f_s16_f64(); return false;
-                    case 4ULL: do_i2f_s32_f64(); return false;
-                    case 8ULL: do_i2f_s64_f64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 1ULL: return &InstrSwitch::do_i2f_s8_f64;
+                    case 2ULL: return &InstrSwitch::do_i2f_s16_f64;
+                    case 4ULL: return &InstrSwitch::do_i2f_s32_f64;
+                    case 8ULL: return &InstrSwitch::do_i2f_s64_f64;
+                    default: return nullptr;
                     }
-                default: UNREACHABLE(); return false;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
                 case 4ULL:
-                    switch (operands().back()->count())
+                    switch (back_count)
                     {
-                    case 1ULL: do_i2f_u8_f32(); return false;
-                    case 2ULL: do_i2f_u16_f32(); return false;
-                    case 4ULL: do_i2f_u32_f32(); return false;
-                    case 8ULL: do_i2f_u64_f32(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 1ULL: return &InstrSwitch::do_i2f_u8_f32;
+                    case 2ULL: return &InstrSwitch::do_i2f_u16_f32;
+                    case 4ULL: return &InstrSwitch::do_i2f_u32_f32;
+                    case 8ULL: return &InstrSwitch::do_i2f_u64_f32;
+                    default: return nullptr;
                     }
                 case 8ULL:
-                    switch (operands().back()->count())
+                    switch (back_count)
                     {
-                    case 1ULL: do_i2f_u8_f64(); return false;
-                    case 2ULL: do_i2f_u16_f64(); return false;
-                    case 4ULL: do_i2f_u32_f64(); return false;
-                    case 8ULL: do_i2f_u64_f64(); return false;
-                    default: UNREACHABLE(); return false;
+                    case 1ULL: return &InstrSwitch::do_i2f_u8_f64;
+                    case 2ULL: return &InstrSwitch::do_i2f_u16_f64;
+                    case 4ULL: return &InstrSwitch::do_i2f_u32_f64;
+                    case 8ULL: return &InstrSwitch::do_i2f_u64_f64;
+                    default: return nullptr;
                     }
-                default: UNREACHABLE(); return false;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::P2I:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().front()->count())
+                switch (front_count)
                 {
-                case 1ULL: do_p2i_8(); return false;
-                case 2ULL: do_p2i_16(); return false;
-                case 4ULL: do_p2i_32(); return false;
-                case 8ULL: do_p2i_64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_p2i_8;
+                case 2ULL: return &InstrSwitch::do_p2i_16;
+                case 4ULL: return &InstrSwitch::do_p2i_32;
+                case 8ULL: return &InstrSwitch::do_p2i_64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::I2P:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 1ULL: do_i2p_8(); return false;
-                case 2ULL: do_i2p_16(); return false;
-                case 4ULL: do_i2p_32(); return false;
-                case 8ULL: do_i2p_64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_i2p_8;
+                case 2ULL: return &InstrSwitch::do_i2p_16;
+                case 4ULL: return &InstrSwitch::do_i2p_32;
+                case 8ULL: return &InstrSwitch::do_i2p_64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::LESS:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 1ULL: do_less_s8(); return false;
-                case 2ULL: do_less_s16(); return false;
-                case 4ULL: do_less_s32(); return false;
-                case 8ULL: do_less_s64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_less_s8;
+                case 2ULL: return &InstrSwitch::do_less_s16;
+                case 4ULL: return &InstrSwitch::do_less_s32;
+                case 8ULL: return &InstrSwitch::do_less_s64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 1ULL: do_less_u8(); return false;
-                case 2ULL: do_less_u16(); return false;
-                case 4ULL: do_less_u32(); return false;
-                case 8ULL: do_less_u64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_less_u8;
+                case 2ULL: return &InstrSwitch::do_less_u16;
+                case 4ULL: return &InstrSwitch::do_less_u32;
+                case 8ULL: return &InstrSwitch::do_less_u64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 4ULL: do_less_f32(); return false;
-                case 8ULL: do_less_f64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_less_f32;
+                case 8ULL: return &InstrSwitch::do_less_f64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING_UNORDERED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 4ULL: do_less_w32(); return false;
-                case 8ULL: do_less_w64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_less_w32;
+                case 8ULL: return &InstrSwitch::do_less_w64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::LESS_EQUAL:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 1ULL: do_less_equal_s8(); return false;
-                case 2ULL: do_less_equal_s16(); return false;
-                case 4ULL: do_less_equal_s32(); return false;
-                case 8ULL: do_less_equal_s64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_less_equal_s8;
+                case 2ULL: return &InstrSwitch::do_less_equal_s16;
+                case 4ULL: return &InstrSwitch::do_less_equal_s32;
+                case 8ULL: return &InstrSwitch::do_less_equal_s64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 1ULL: do_less_equal_u8(); return false;
-                case 2ULL: do_less_equal_u16(); return false;
-                case 4ULL: do_less_equal_u32(); return false;
-                case 8ULL: do_less_equal_u64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_less_equal_u8;
+                case 2ULL: return &InstrSwitch::do_less_equal_u16;
+                case 4ULL: return &InstrSwitch::do_less_equal_u32;
+                case 8ULL: return &InstrSwitch::do_less_equal_u64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 4ULL: do_less_equal_f32(); return false;
-                case 8ULL: do_less_equal_f64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_less_equal_f32;
+                case 8ULL: return &InstrSwitch::do_less_equal_f64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING_UNORDERED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 4ULL: do_less_equal_w32(); return false;
-                case 8ULL: do_less_equal_w64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_less_equal_w32;
+                case 8ULL: return &InstrSwitch::do_less_equal_w64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::GREATER:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 1ULL: do_greater_s8(); return false;
-                case 2ULL: do_greater_s16(); return false;
-                case 4ULL: do_greater_s32(); return false;
-                case 8ULL: do_greater_s64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_greater_s8;
+                case 2ULL: return &InstrSwitch::do_greater_s16;
+                case 4ULL: return &InstrSwitch::do_greater_s32;
+                case 8ULL: return &InstrSwitch::do_greater_s64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 1ULL: do_greater_u8(); return false;
-                case 2ULL: do_greater_u16(); return false;
-                case 4ULL: do_greater_u32(); return false;
-                case 8ULL: do_greater_u64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_greater_u8;
+                case 2ULL: return &InstrSwitch::do_greater_u16;
+                case 4ULL: return &InstrSwitch::do_greater_u32;
+                case 8ULL: return &InstrSwitch::do_greater_u64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 4ULL: do_greater_f32(); return false;
-                case 8ULL: do_greater_f64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_greater_f32;
+                case 8ULL: return &InstrSwitch::do_greater_f64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING_UNORDERED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 4ULL: do_greater_w32(); return false;
-                case 8ULL: do_greater_w64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_greater_w32;
+                case 8ULL: return &InstrSwitch::do_greater_w64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::GREATER_EQUAL:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::SIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 1ULL: do_greater_equal_s8(); return false;
-                case 2ULL: do_greater_equal_s16(); return false;
-                case 4ULL: do_greater_equal_s32(); return false;
-                case 8ULL: do_greater_equal_s64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_greater_equal_s8;
+                case 2ULL: return &InstrSwitch::do_greater_equal_s16;
+                case 4ULL: return &InstrSwitch::do_greater_equal_s32;
+                case 8ULL: return &InstrSwitch::do_greater_equal_s64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 1ULL: do_greater_equal_u8(); return false;
-                case 2ULL: do_greater_equal_u16(); return false;
-                case 4ULL: do_greater_equal_u32(); return false;
-                case 8ULL: do_greater_equal_u64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_greater_equal_u8;
+                case 2ULL: return &InstrSwitch::do_greater_equal_u16;
+                case 4ULL: return &InstrSwitch::do_greater_equal_u32;
+                case 8ULL: return &InstrSwitch::do_greater_equal_u64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 4ULL: do_greater_equal_f32(); return false;
-                case 8ULL: do_greater_equal_f64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_greater_equal_f32;
+                case 8ULL: return &InstrSwitch::do_greater_equal_f64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING_UNORDERED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 4ULL: do_greater_equal_w32(); return false;
-                case 8ULL: do_greater_equal_w64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_greater_equal_w32;
+                case 8ULL: return &InstrSwitch::do_greater_equal_w64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::EQUAL:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 1ULL: do_equal_u8(); return false;
-                case 2ULL: do_equal_u16(); return false;
-                case 4ULL: do_equal_u32(); return false;
-                case 8ULL: do_equal_u64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_equal_u8;
+                case 2ULL: return &InstrSwitch::do_equal_u16;
+                case 4ULL: return &InstrSwitch::do_equal_u32;
+                case 8ULL: return &InstrSwitch::do_equal_u64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 4ULL: do_equal_f32(); return false;
-                case 8ULL: do_equal_f64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_equal_f32;
+                case 8ULL: return &InstrSwitch::do_equal_f64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING_UNORDERED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 4ULL: do_equal_w32(); return false;
-                case 8ULL: do_equal_w64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_equal_w32;
+                case 8ULL: return &InstrSwitch::do_equal_w64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::UNEQUAL:
-            switch (instruction().modifier())
+            switch (instruction.modifier())
             {
             case Instruction::Modifier::UNSIGNED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 1ULL: do_unequal_u8(); return false;
-                case 2ULL: do_unequal_u16(); return false;
-                case 4ULL: do_unequal_u32(); return false;
-                case 8ULL: do_unequal_u64(); return false;
-                default: UNREACHABLE(); return false;
+                case 1ULL: return &InstrSwitch::do_unequal_u8;
+                case 2ULL: return &InstrSwitch::do_unequal_u16;
+                case 4ULL: return &InstrSwitch::do_unequal_u32;
+                case 8ULL: return &InstrSwitch::do_unequal_u64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 4ULL: do_unequal_f32(); return false;
-                case 8ULL: do_unequal_f64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_unequal_f32;
+                case 8ULL: return &InstrSwitch::do_unequal_f64;
+                default: return nullptr;
                 }
             case Instruction::Modifier::FLOATING_UNORDERED:
-                switch (operands().back()->count())
+                switch (back_count)
                 {
-                case 4ULL: do_unequal_w32(); return false;
-                case 8ULL: do_unequal_w64(); return false;
-                default: UNREACHABLE(); return false;
+                case 4ULL: return &InstrSwitch::do_unequal_w32;
+                case 8ULL: return &InstrSwitch::do_unequal_w64;
+                default: return nullptr;
                 }
-            default: UNREACHABLE(); return false;
+            default: return nullptr;
             }
 
         case Instruction::Opcode::ISNAN:
-            switch (operands().back()->count())
+            switch (back_count)
             {
-            case 4ULL: do_isnan_w32(); return false;
-            case 8ULL: do_isnan_w64(); return false;
-            default: UNREACHABLE(); return false;
+            case 4ULL: return &InstrSwitch::do_isnan_w32;
+            case 8ULL: return &InstrSwitch::do_isnan_w64;
+            default: return nullptr;
             }
 
-        case Instruction::Opcode::VA_START: do_va_start(); return false;
-        case Instruction::Opcode::VA_END: do_va_end(); return false;
-        case Instruction::Opcode::VA_ARG: do_va_arg(); return false;
-        case Instruction::Opcode::VA_COPY: do_va_copy(); return false;
+        case Instruction::Opcode::VA_START: return &InstrSwitch::do_va_start;
+        case Instruction::Opcode::VA_END: return &InstrSwitch::do_va_end;
+        case Instruction::Opcode::VA_ARG: return &InstrSwitch::do_va_arg;
+        case Instruction::Opcode::VA_COPY: return &InstrSwitch::do_va_copy;
 
-        case Instruction::Opcode::JUMP: do_jump(); return true;
-        case Instruction::Opcode::BRANCH: do_branch(); return true;
-        case Instruction::Opcode::CALL: do_call(); return true;
-        case Instruction::Opcode::RET: do_ret(); return true;
+        case Instruction::Opcode::JUMP: return &InstrSwitch::do_jump;
+        case Instruction::Opcode::BRANCH: return &InstrSwitch::do_branch;
+        case Instruction::Opcode::CALL: return &InstrSwitch::do_call;
+        case Instruction::Opcode::RET: return &InstrSwitch::do_ret;
 
-        default: UNREACHABLE(); return false;
+        default: return nullptr;
     }
 }
 
@@ -1,8 +1,13 @@
 #include <sala/interpreter.hpp>
+#include <sala/decoded_program.hpp>
 #include <sala/platform_specifics.hpp>
 #include <utility/assumptions.hpp>
 #include <utility/invariants.hpp>
 #include <utility/development.hpp>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <type_traits>
 #include <cstring>
 #include <cmath>
 
@@ -13,15 +18,51 @@ Interpreter::Interpreter(ExecState* const state, ExternCode* const extern_code,
     : state_{ state }
     , extern_code_{ extern_code }
     , analyzers_{ analyzers }
+    , analyzers_of_opcodes_{ Analyzer::OpcodeMask{}.size() }
     , num_steps_{ 0ULL }
-{}
+    , fast_handlers_{}
+    , jit_{ nullptr }
+    , jit_entry_counted_{ false }
+    , aot_module_{ nullptr }
+{
+    for (std::size_t i = 0ULL; i != analyzers_of_opcodes_.size(); ++i)
+        for (Analyzer* const analyzer : analyzers_)
+            if (analyzer->interests().test(i))
+                analyzers_of_opcodes_.at(i).push_back(analyzer);
+}
 
 
-void Interpreter::step()
+void Interpreter::step_with_analyzers()
 {
+    if (!begin_step())
+        return;
+
+    std::vector<Analyzer*> const& interested{ analyzers(instruction().opcode()) };
+
+    for (auto& analyzer : interested)
+    {
+        analyzer->pre();
+        if (done())
+            return;
+    }
+
+    execute_instruction();
+
     if (done())
         return;
 
+    for (auto& analyzer : interested)
+        analyzer->post();
+
+    finish_step();
+}
+
+
+bool Interpreter::begin_step()
+{
+    if (done())
+        return false;
+
     if (instruction().opcode() == Instruction::Opcode::__INVALID__)
     {
         state().set_stage(ExecState::Stage::FINISHED);
@@ -30,72 +71,37 @@ void Interpreter::step()
             "sala::Interpreter",
             state().make_error_message("__INVALID__ instruction reached. ")
             );
-        return;
+        return false;
     }
 
-    for (auto& analyzer : analyzers())
-    {
-        analyzer->pre();
-        if (done())
-            return;
-    }
+    return true;
+}
+
 
-    if (!do_instruction_switch())
+void Interpreter::execute_instruction()
+{
+    if (!do_instruction_switch(state().current_decoded_instruction()))
         state().stack_top().ip().next();
     ++num_steps_;
+}
 
-    if (done())
-        return;
-
-    for (auto& analyzer : analyzers())
-        analyzer->post();
 
+void Interpreter::finish_step()
+{
     if (!done() && state().stack_segment().size() <= state().stack_exit_depth())
     {
         if (state().stage() == ExecState::Stage::INITIALIZING)
         {
             state().set_stage(ExecState::Stage::EXECUTING);
 
-            state().stack_segment().push_back(StackRecord(state().pointer_model(), program().functions().at(program().entry_function())));
-            auto const& params{ state().stack_top().parameters() };
-
-            if (params.empty())
-            {
-                // void main(void)
-                // => nothing to do.
-            }
-            else if (params.size() == 1ULL)
-            {
-                // int main(void)
-                ASSUMPTION(params.front().count() == state().pointer_model()->sizeof_pointer());
-                params.front().write(state().exit_code_memory_block().start());
-            }
-            else if (params.size() == 2ULL)
-            {
-                // void main(int argc, char* argv[])
-                ASSUMPTION(params.front().count() == sizeof(int));
-                ASSUMPTION(params.back().count() == state().pointer_model()->sizeof_pointer());
-                params.front().write(state().argc());
-                params.back().write(state().argv().start());
-            }
-            else
-            {
-                // int main(int argc, char* argv[])
-                ASSUMPTION(params.size() == 3ULL);
-                ASSUMPTION(params.front().count() == state().pointer_model()->sizeof_pointer());
-                ASSUMPTION(params.at(1ULL).count() == sizeof(int));
-                ASSUMPTION(params.back().count() == state().pointer_model()->sizeof_pointer());
-                params.front().write(state().exit_code_memory_block().start());
-                params.at(1ULL).write(state().argc());
-                params.back().write(state().argv().start());
-            }
-
+            state().push_stack_record(program().functions().at(program().entry_function()));
+            state().write_entry_function_parameters();
             state().stack_top().ip().jump(0U);
         }
         else if (state().stage() != ExecState::Stage::FINISHED && !state().atexit_stack().empty())
         {
             state().set_stage(ExecState::Stage::TERMINATING);
-            state().stack_segment().push_back(StackRecord(state().pointer_model(), program().functions().at(state().pop_atexit_function())));
+            state().push_stack_record(program().functions().at(state().pop_atexit_function()));
             state().stack_top().ip().jump(0U);
             state().update_current_values();
             extern_code_->call_code_of_current_function_if_registered_external();
@@ -123,23 +129,112 @@ void Interpreter::step()
 
 void Interpreter::run()
 {
-    while (!done())
-        step();
+    run_until(std::numeric_limits<std::uint64_t>::max());
+}
+
+
+void Interpreter::run_until(std::uint64_t const max_num_steps)
+{
+    if (analyzers().empty())
+    {
+        run_without_analyzers(max_num_steps);
+        return;
+    }
+    while (!done() && num_steps_ < max_num_steps)
+        step_with_analyzers();
+}
+
+
+void Interpreter::run_without_analyzers(std::uint64_t const max_num_steps)
+{
+    if (fast_handlers_.size() != state().decoded_program().num_instructions())
+        build_fast_handlers();
+
+    while (!done() && num_steps_ < max_num_steps)
+    {
+        if (jit_ != nullptr && ip().instr() == 0U && !jit_entry_counted_ && run_compiled_blocks(max_num_steps))
+            continue;
+        jit_entry_counted_ = false;
+
+        DecodedInstruction const& decoded{ state().current_decoded_instruction() };
+        if (decoded.handler == nullptr || decoded.changes_stack)
+        {
+            step_with_analyzers();
+            continue;
+        }
+        if (decoded.fusion != DecodedInstruction::Fusion::NONE &&
+                num_steps_ + DecodedFunction::num_fused_instructions(decoded.fusion) <= max_num_steps)
+        {
+            do_fused(decoded);
+            continue;
+        }
+
+        FastHandler const fast_handler{ fast_handlers_[decoded.index] };
+        if (fast_handler != nullptr)
+            fast_handler(state().current_operands().begin(), decoded);
+        else
+            (this->*decoded.handler)();
+        ++num_steps_;
+
+        if (decoded.transfers_control)
+        {
+            if (done())
+                return;
+            state().update_current_values();
+        }
+        else
+        {
+            ip().next();
+            if (done())
+                return;
+            state().update_current_values_to_next_instruction();
+        }
+    }
 }
 
 
 void Interpreter::run(double const max_seconds)
 {
-    std::chrono::system_clock::time_point const  start_time = std::chrono::system_clock::now();
-    run([start_time, max_seconds](std::string& error_message) {
-        double const num_seconds = std::chrono::duration<double>(std::chrono::system_clock::now() - start_time).count();
-        if (num_seconds >= max_seconds)
+    if (max_seconds > 0.0)
+        run(Budget{ max_seconds });
+    else if (!done())
+        terminate_run("[TIME OUT] The time budget " + std::to_string(max_seconds) + "s for the execution was exhausted.");
+}
+
+
+void Interpreter::run(Budget const& budget)
+{
+    std::chrono::steady_clock::time_point const  start_time = std::chrono::steady_clock::now();
+    std::uint64_t const  max_num_steps{
+        budget.max_steps == 0ULL || num_steps_ > std::numeric_limits<std::uint64_t>::max() - budget.max_steps ?
+            std::numeric_limits<std::uint64_t>::max() :
+            num_steps_ + budget.max_steps
+        };
+    std::uint64_t const  check_interval{ std::max<std::uint64_t>(budget.check_interval, 1ULL) };
+    while (!done())
+    {
+        if (budget.stop_flag != nullptr && budget.stop_flag->load(std::memory_order_relaxed))
+        {
+            terminate_run("[STOPPED] The execution was stopped from outside.");
+            return;
+        }
+        if (num_steps_ >= max_num_steps)
         {
-            error_message = "[TIME OUT] The time budget " + std::to_string(max_seconds) + "s for the execution was exhausted.";
-            return true;
+            terminate_run("[STEP LIMIT] The budget " + std::to_string(budget.max_steps) + " of instructions for the execution was exhausted.");
+            return;
         }
-        return false;
-    });
+        if (budget.max_seconds > 0.0)
+        {
+            double const num_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+            if (num_seconds >= budget.max_seconds)
+            {
+                terminate_run("[TIME OUT] The time budget " + std::to_string(budget.max_seconds) + "s for the execution was exhausted.");
+                return;
+            }
+        }
+
+        run_until(max_num_steps - num_steps_ > check_interval ? num_steps_ + check_interval : max_num_steps);
+    }
 }
 
 
@@ -151,12 +246,7 @@ void Interpreter::run(std::function<bool(std::string&)> const&  terminator)
         error_message.clear();
         if (terminator(error_message))
         {
-            state().set_stage(ExecState::Stage::FINISHED);
-            state().set_termination(
-                ExecState::Termination::ERROR,
-                "sala::Interpreter",
-                state().make_error_message(error_message + " [Processed instructions: " + std::to_string(num_steps()) + "]")
-                );
+            terminate_run(error_message);
             return;
         }
 
@@ -165,6 +255,315 @@ void Interpreter::run(std::function<bool(std::string&)> const&  terminator)
 }
 
 
+bool Interpreter::run_slice(std::uint64_t const max_num_steps)
+{
+    run_until(num_steps_ > std::numeric_limits<std::uint64_t>::max() - max_num_steps ?
+                std::numeric_limits<std::uint64_t>::max() :
+                num_steps_ + max_num_steps);
+    return done();
+}
+
+
+void Interpreter::terminate_run(std::string const& error_message)
+{
+    state().set_stage(ExecState::Stage::FINISHED);
+    state().set_termination(
+        ExecState::Termination::ERROR,
+        "sala::Interpreter",
+        state().make_error_message(error_message + " [Processed instructions: " + std::to_string(num_steps()) + "]")
+        );
+}
+
+
+void Interpreter::enable_jit(std::uint32_t const hot_threshold)
+{
+    if (!Jit::is_supported())
+        return;
+    if (jit_ == nullptr)
+        jit_ = std::make_unique<Jit>(&state().decoded_program(), hot_threshold);
+    else
+        jit_->set_hot_threshold(hot_threshold);
+}
+
+
+void Interpreter::enable_aot(std::shared_ptr<AotModule const> const& module)
+{
+    ASSUMPTION(module != nullptr);
+    if (jit_ == nullptr)
+        jit_ = std::make_unique<Jit>(&state().decoded_program(), std::numeric_limits<std::uint32_t>::max());
+    for (AotModule::Block const& block : module->blocks())
+        jit_->add_native_block(block.func_idx, block.block_idx, block.code, block.num_instructions);
+    aot_module_ = module;
+}
+
+
+// The shifts of the handlers SHL and SHR, for the variants generated by Interpreter::specialize().
+template<typename T>
+struct ShiftLeft
+{
+    T operator()(T const value, T const shift) const { return (T)(value << shift); }
+};
+
+
+template<typename T>
+struct ShiftRight
+{
+    T operator()(T const value, T const shift) const { return (T)(value >> shift); }
+};
+
+
+// Calls the visitor with a null pointer to the integer type of the passed count of bytes.
+template<typename Result, typename Visitor>
+static Result visit_integer_type(std::size_t const num_bytes, bool const is_signed, Visitor const& visitor)
+{
+    switch (num_bytes)
+    {
+        case 1ULL: return is_signed ? visitor((std::int8_t*)nullptr) : visitor((std::uint8_t*)nullptr);
+        case 2ULL: return is_signed ? visitor((std::int16_t*)nullptr) : visitor((std::uint16_t*)nullptr);
+        case 4ULL: return is_signed ? visitor((std::int32_t*)nullptr) : visitor((std::uint32_t*)nullptr);
+        case 8ULL: return is_signed ? visitor((std::int64_t*)nullptr) : visitor((std::uint64_t*)nullptr);
+        default: return nullptr;
+    }
+}
+
+
+// Calls the visitor with a null pointer to the floating point type of the passed count of bytes.
+template<typename Result, typename Visitor>
+static Result visit_floating_type(std::size_t const num_bytes, Visitor const& visitor)
+{
+    switch (num_bytes)
+    {
+        case 4ULL: return visitor((float*)nullptr);
+        case 8ULL: return visitor((double*)nullptr);
+        default: return nullptr;
+    }
+}
+
+
+Interpreter::FastHandler Interpreter::specialize(DecodedFunction const& function, DecodedInstruction const& decoded)
+{
+    using Opcode = Instruction::Opcode;
+    using Modifier = Instruction::Modifier;
+
+    std::uint32_t const num_operands{ decoded.operands_end - decoded.operands_begin };
+    if (decoded.handler == nullptr || num_operands < 2U)
+        return nullptr;
+
+    Instruction const& instruction{ *decoded.instruction };
+    Opcode const opcode{ instruction.opcode() };
+    DecodedOperand const& last{ function.operands().at(decoded.operands_end - 1U) };
+    bool const immediate{ last.descriptor == Instruction::Descriptor::CONSTANT && last.num_bytes <= sizeof(decoded.immediate) };
+
+    auto const copy = [immediate](auto* const type) -> FastHandler {
+        using T = std::remove_pointer_t<decltype(type)>;
+        return immediate ?
+            static_cast<FastHandler>(&Interpreter::do_copy_fast<T, true>) :
+            static_cast<FastHandler>(&Interpreter::do_copy_fast<T, false>);
+    };
+    auto const arithmetic = [immediate](auto* const type, auto* const operation) -> FastHandler {
+        using T = std::remove_pointer_t<decltype(type)>;
+        using Operation = std::remove_pointer_t<decltype(operation)>;
+        return immediate ?
+            static_cast<FastHandler>(&Interpreter::do_arithmetic_fast<T, Operation, true>) :
+            static_cast<FastHandler>(&Interpreter::do_arithmetic_fast<T, Operation, false>);
+    };
+    auto const integer_arithmetic = [opcode, &arithmetic](auto* const type) -> FastHandler {
+        using T = std::remove_pointer_t<decltype(type)>;
+        switch (opcode)
+        {
+            case Opcode::ADD: return arithmetic(type, (std::plus<T>*)nullptr);
+            case Opcode::SUB: return arithmetic(type, (std::minus<T>*)nullptr);
+            case Opcode::MUL: return arithmetic(type, (std::multiplies<T>*)nullptr);
+            case Opcode::AND: return arithmetic(type, (std::bit_and<T>*)nullptr);
+            case Opcode::OR: return arithmetic(type, (std::bit_or<T>*)nullptr);
+            case Opcode::XOR: return arithmetic(type, (std::bit_xor<T>*)nullptr);
+            case Opcode::SHL: return arithmetic(type, (ShiftLeft<T>*)nullptr);
+            case Opcode::SHR: return arithmetic(type, (ShiftRight<T>*)nullptr);
+            default: return nullptr;
+        }
+    };
+    auto const floating_arithmetic = [opcode, &arithmetic](auto* const type) -> FastHandler {
+        using T = std::remove_pointer_t<decltype(type)>;
+        switch (opcode)
+        {
+            case Opcode::ADD: return arithmetic(type, (std::plus<T>*)nullptr);
+            case Opcode::SUB: return arithmetic(type, (std::minus<T>*)nullptr);
+            case Opcode::MUL: return arithmetic(type, (std::multiplies<T>*)nullptr);
+            default: return nullptr;
+        }
+    };
+    auto const compare = [opcode, immediate](auto* const type) -> FastHandler {
+        using T = std::remove_pointer_t<decltype(type)>;
+        auto const handler = [immediate](auto* const comparison) -> FastHandler {
+            using Comparison = std::remove_pointer_t<decltype(comparison)>;
+            return immediate ?
+                static_cast<FastHandler>(&Interpreter::do_compare_fast<T, Comparison, true>) :
+                static_cast<FastHandler>(&Interpreter::do_compare_fast<T, Comparison, false>);
+        };
+        switch (opcode)
+        {
+            case Opcode::LESS: return handler((std::less<T>*)nullptr);
+            case Opcode::LESS_EQUAL: return handler((std::less_equal<T>*)nullptr);
+            case Opcode::GREATER: return handler((std::greater<T>*)nullptr);
+            case Opcode::GREATER_EQUAL: return handler((std::greater_equal<T>*)nullptr);
+            case Opcode::EQUAL: return handler((std::equal_to<T>*)nullptr);
+            case Opcode::UNEQUAL: return handler((std::not_equal_to<T>*)nullptr);
+            default: return nullptr;
+        }
+    };
+
+    std::size_t const num_bytes{ function.operands().at(decoded.operands_begin).num_bytes };
+    switch (opcode)
+    {
+        case Opcode::COPY:
+            return num_operands == 2U ? visit_integer_type<FastHandler>(num_bytes, false, copy) : nullptr;
+
+        case Opcode::ADD:
+        case Opcode::SUB:
+        case Opcode::MUL:
+        case Opcode::AND:
+        case Opcode::OR:
+        case Opcode::XOR:
+        case Opcode::SHL:
+        case Opcode::SHR:
+            if (num_operands != 3U)
+                return nullptr;
+            if (instruction.modifier() == Modifier::FLOATING || instruction.modifier() == Modifier::FLOATING_UNORDERED)
+                return visit_floating_type<FastHandler>(num_bytes, floating_arithmetic);
+            return visit_integer_type<FastHandler>(num_bytes, instruction.modifier() == Modifier::SIGNED, integer_arithmetic);
+
+        case Opcode::LESS:
+        case Opcode::LESS_EQUAL:
+        case Opcode::GREATER:
+        case Opcode::GREATER_EQUAL:
+        case Opcode::EQUAL:
+        case Opcode::UNEQUAL:
+            if (num_operands != 3U)
+                return nullptr;
+            switch (instruction.modifier())
+            {
+                case Modifier::SIGNED: return visit_integer_type<FastHandler>(last.num_bytes, true, compare);
+                case Modifier::UNSIGNED: return visit_integer_type<FastHandler>(last.num_bytes, false, compare);
+                case Modifier::FLOATING: return visit_floating_type<FastHandler>(last.num_bytes, compare);
+                default: return nullptr;
+            }
+
+        default:
+            return nullptr;
+    }
+}
+
+
+void Interpreter::build_fast_handlers()
+{
+    fast_handlers_.assign(state().decoded_program().num_instructions(), nullptr);
+    for (DecodedFunction const& decoded_function : state().decoded_program().functions())
+        for (DecodedInstruction const& decoded : decoded_function.instructions())
+            fast_handlers_[decoded.index] = specialize(decoded_function, decoded);
+}
+
+
+bool Interpreter::run_compiled_blocks(std::uint64_t const max_num_steps)
+{
+    StackRecord& record{ state().stack_top() };
+    if (record.operand_table().empty())
+        return false;
+    bool executed{ false };
+    while (true)
+    {
+        Jit::Block const* const block{ jit_->enter(record.function_index(), record.ip().block()) };
+        if (block == nullptr || max_num_steps - num_steps_ < block->num_instructions)
+            break;
+        record.ip().jump(block->code(record.operand_table().data()));
+        num_steps_ += block->num_instructions;
+        executed = true;
+    }
+    if (executed)
+        state().update_current_values();
+    // The entry to the current block was counted by Jit::enter() already.
+    jit_entry_counted_ = executed;
+    return executed;
+}
+
+
+void Interpreter::do_fused(DecodedInstruction const& decoded)
+{
+    // None of the fused instructions can terminate the execution. All of them take their
+    // operands from the operand table of the record, where the operands of the following
+    // instructions are at fixed offsets from those of the first one.
+    MemBlock const* const* const ops{ state().current_operands().begin() };
+    auto const operands_of = [ops, &decoded](std::uint32_t const i) {
+        return ops + ((&decoded)[i].operands_begin - decoded.operands_begin);
+    };
+
+    switch (decoded.fusion)
+    {
+        case DecodedInstruction::Fusion::COMPARE_BRANCH:
+        {
+            FastHandler const compare{ fast_handlers_[decoded.index] };
+            if (compare != nullptr)
+                compare(ops, decoded);
+            else
+                (this->*decoded.handler)();
+            ip().jump(
+                *(std::uint8_t*)ops[0]->start() == 0U ?
+                    (&decoded)[1].successors.front() :
+                    (&decoded)[1].successors.back()
+                );
+            num_steps_ += 2ULL;
+            state().update_current_values();
+            return;
+        }
+
+        case DecodedInstruction::Fusion::LOAD_COMPUTE_STORE:
+        {
+            FastHandler const compute{ fast_handlers_[(&decoded)[1].index] };
+            if (compute == nullptr)
+            {
+                // There is no variant of the computation to combine with, so the
+                // instructions are executed one by one.
+                for (std::uint32_t i = 0U; i != 3U; ++i)
+                {
+                    (this->*(&decoded)[i].handler)();
+                    ip().next();
+                    state().update_current_values_to_next_instruction();
+                }
+                num_steps_ += 3ULL;
+                return;
+            }
+            // LOAD vN vP
+            std::memcpy(ops[0]->start(), ops[1]->read<MemPtr>(), ops[0]->count());
+            // ADD/SUB/MUL/AND/OR/XOR/SHL/SHR vM ... vN ...
+            compute(operands_of(1U), (&decoded)[1]);
+            // STORE vP vM
+            MemBlock const* const* const store{ operands_of(2U) };
+            std::memcpy(store[0]->read<MemPtr>(), store[1]->start(), store[1]->count());
+            break;
+        }
+
+        case DecodedInstruction::Fusion::ADDRESS_MOVEPTR_LOAD:
+        {
+            // ADDRESS vA xB
+            ops[0]->write<MemPtr>(ops[1]->start());
+            // MOVEPTR vP vA vS vT
+            MemBlock const* const* const moveptr{ operands_of(1U) };
+            moveptr[0]->write_shifted(moveptr[1]->start(), moveptr[2]->as_shift() * (std::int64_t)moveptr[3]->as_shift());
+            // LOAD vN vP
+            MemBlock const* const* const load{ operands_of(2U) };
+            std::memcpy(load[0]->start(), load[1]->read<MemPtr>(), load[0]->count());
+            break;
+        }
+
+        default: UNREACHABLE(); return;
+    }
+
+    for (std::uint32_t i = 0U; i != 3U; ++i)
+        ip().next();
+    num_steps_ += 3ULL;
+    state().update_current_values();
+}
+
+
 void Interpreter::do_halt()
 {
     state().set_stage(ExecState::Stage::FINISHED);
@@ -296,8 +695,7 @@ void Interpreter::do_malloc()
     }
     try
     {
-        MemBlock mb{ state().pointer_model(), operands().back()->as_size() };
-        state().heap_segment().insert({ mb.start(), mb });
+        MemBlock const& mb{ state().heap_segment().allocate(operands().back()->as_size()) };
         operands().front()->write<MemPtr>(mb.start());
     }
     catch(const std::exception&)
@@ -309,7 +707,7 @@ void Interpreter::do_malloc()
 
 void Interpreter::do_free()
 {
-    state().heap_segment().erase( operands().front()->read<MemPtr>() );
+    state().heap_segment().release( operands().front()->read<MemPtr>() );
 }
 
 
@@ -1575,8 +1973,7 @@ void Interpreter::do_va_start()
     MemPtr array;
     try
     {
-        MemBlock mb{ state().pointer_model(), array_size };
-        array = state().heap_segment().insert({ mb.start(), mb }).first->first;
+        array = state().heap_segment().allocate(array_size).start();
     }
     catch(const std::exception&)
     {
@@ -1611,7 +2008,7 @@ void Interpreter::do_va_end()
     // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
     platform_linux_64_bit::va_list* const va_list_ptr{ (platform_linux_64_bit::va_list*)operands().front()->read<MemPtr>() };
-    state().heap_segment().erase( (MemPtr)va_list_ptr->reg_save_area );
+    state().heap_segment().release( (MemPtr)va_list_ptr->reg_save_area );
 }
 
 
@@ -1638,7 +2035,7 @@ void Interpreter::do_va_copy()
 
 void Interpreter::do_jump()
 {
-    ip().jump( block().successors().front() );
+    ip().jump( state().current_decoded_instruction().successors.front() );
 }
 
 
@@ -1646,8 +2043,8 @@ void Interpreter::do_branch()
 {
     ip().jump(
         *(std::uint8_t*)operands().front()->start() == 0U ?
-            block().successors().front() :
-            block().successors().back()
+            state().current_decoded_instruction().successors.front() :
+            state().current_decoded_instruction().successors.back()
         );
 }
 
@@ -1658,11 +2055,16 @@ void Interpreter::do_call()
     if (instruction().descriptors().front() == Instruction::Descriptor::FUNCTION)
         func_idx = instruction().operands().front();
     else
-        func_idx = state().functions_at_addresses().at(operands().front()->read<MemPtr>());
+    {
+        ExecState::CallTarget const* const target{ state().call_target(operands().front()->read<MemPtr>()) };
+        if (target == nullptr)
+            throw std::out_of_range("sala::Interpreter: no function at the called address.");
+        func_idx = target->func_idx;
+    }
 
     Function const& func = program().functions().at(func_idx);
 
-    if (!state().can_allocate(func.initial_stack_bytes()))
+    if (!state().can_allocate(state().decoded_program().function(func_idx).initial_stack_bytes()))
     {
         state().set_stage(ExecState::Stage::FINISHED);
         state().set_termination(
@@ -1672,6 +2074,9 @@ void Interpreter::do_call()
             );
         return;
     }
+    // The recycled stack records hold segments as well.
+    if (!state().has_free_segments(func.parameters().size() + func.local_variables().size()))
+        state().release_recycled_stack_records();
     if (!state().has_free_segments(func.parameters().size() + func.local_variables().size()))
     {
         state().set_stage(ExecState::Stage::FINISHED);
@@ -1685,7 +2090,7 @@ void Interpreter::do_call()
 
     state().stack_top().ip().next();
 
-    state().stack_segment().push_back(StackRecord(state().pointer_model(), func));
+    state().push_stack_record(func);
 
     auto const& params = state().stack_top().parameters();
 
@@ -1707,7 +2112,7 @@ void Interpreter::do_call()
 
 void Interpreter::do_ret()
 {
-    state().stack_segment().pop_back();
+    state().pop_stack_record();
 }
 
 
@@ -0,0 +1,286 @@
+#include <sala/jit.hpp>
+#include <utility/assumptions.hpp>
+#include <utility/invariants.hpp>
+#include <algorithm>
+#include <initializer_list>
+#include <cstring>
+#if defined(__x86_64__) && defined(__linux__)
+#   define SALA_JIT_X86_64_LINUX
+#   include <sys/mman.h>
+#endif
+
+namespace sala {
+
+
+static void emit_bytes(std::vector<std::uint8_t>& code, std::initializer_list<std::uint8_t> const bytes)
+{
+    code.insert(code.end(), bytes.begin(), bytes.end());
+}
+
+
+static void emit_uint32(std::vector<std::uint8_t>& code, std::uint32_t const value)
+{
+    for (std::uint32_t i = 0U; i != 4U; ++i)
+        code.push_back((std::uint8_t)(value >> (8U * i)));
+}
+
+
+// REX.W prefix for 8 bytes operations.
+static void emit_rex(std::vector<std::uint8_t>& code, std::size_t const num_bytes)
+{
+    if (num_bytes == 8ULL)
+        code.push_back(0x48U);
+}
+
+
+// rsi := the start of the bytes of the operand at the index in the operand table (in rdi).
+static void emit_operand_address(std::vector<std::uint8_t>& code, std::uint32_t const table_index)
+{
+    emit_bytes(code, { 0x48U, 0x8BU, 0xB7U }); // mov rsi, [rdi + disp32]
+    emit_uint32(code, table_index * (std::uint32_t)sizeof(MemBlock const*));
+    emit_bytes(code, { 0x48U, 0x8BU, 0xB6U }); // mov rsi, [rsi + disp32]
+    emit_uint32(code, (std::uint32_t)MemBlock::data_member_offset());
+    emit_bytes(code, { 0x48U, 0x8BU, 0xB6U }); // mov rsi, [rsi + disp32]
+    emit_uint32(code, (std::uint32_t)detail::MemBlockData::start_member_offset());
+}
+
+
+// Returns the second byte of the SETcc instruction for the comparison, or 0.
+static std::uint8_t setcc_opcode(Instruction::Opcode const opcode, Instruction::Modifier const modifier)
+{
+    bool const is_signed{ modifier == Instruction::Modifier::SIGNED };
+    if (!is_signed && modifier != Instruction::Modifier::UNSIGNED)
+        return 0U;
+    switch (opcode)
+    {
+        case Instruction::Opcode::LESS: return is_signed ? 0x9CU : 0x92U;
+        case Instruction::Opcode::LESS_EQUAL: return is_signed ? 0x9EU : 0x96U;
+        case Instruction::Opcode::GREATER: return is_signed ? 0x9FU : 0x97U;
+        case Instruction::Opcode::GREATER_EQUAL: return is_signed ? 0x9DU : 0x93U;
+        case Instruction::Opcode::EQUAL: return 0x94U;
+        case Instruction::Opcode::UNEQUAL: return 0x95U;
+        default: return 0U;
+    }
+}
+
+
+// Appends the code of the instruction and returns true, or returns false, if the
+// instruction is not supported.
+static bool emit_instruction(
+    DecodedFunction const& decoded_function,
+    DecodedInstruction const& decoded,
+    bool const is_last,
+    std::vector<std::uint8_t>& code
+    )
+{
+    if (decoded.handler == nullptr || decoded.transfers_control != is_last)
+        return false;
+
+    Instruction const& instruction{ *decoded.instruction };
+    std::uint32_t const begin{ decoded.operands_begin };
+    std::uint32_t const num_operands{ decoded.operands_end - decoded.operands_begin };
+    auto const num_bytes = [&decoded_function, begin](std::uint32_t const i) {
+        return decoded_function.operands().at(begin + i).num_bytes;
+    };
+
+    switch (instruction.opcode())
+    {
+        case Instruction::Opcode::NOP:
+            return true;
+
+        case Instruction::Opcode::COPY:
+        {
+            if (num_operands != 2U || (num_bytes(0U) != 4ULL && num_bytes(0U) != 8ULL) || num_bytes(1U) != num_bytes(0U))
+                return false;
+            emit_operand_address(code, begin + 1U);
+            emit_rex(code, num_bytes(0U));
+            emit_bytes(code, { 0x8BU, 0x06U }); // mov eax, [rsi]
+            emit_operand_address(code, begin);
+            emit_rex(code, num_bytes(0U));
+            emit_bytes(code, { 0x89U, 0x06U }); // mov [rsi], eax
+            return true;
+        }
+
+        case Instruction::Opcode::ADD:
+        case Instruction::Opcode::SUB:
+        case Instruction::Opcode::MUL:
+        case Instruction::Opcode::AND:
+        case Instruction::Opcode::OR:
+        case Instruction::Opcode::XOR:
+        {
+            if (num_operands != 3U || (num_bytes(0U) != 4ULL && num_bytes(0U) != 8ULL) ||
+                    num_bytes(1U) != num_bytes(0U) || num_bytes(2U) != num_bytes(0U) ||
+                    instruction.modifier() == Instruction::Modifier::FLOATING ||
+                    instruction.modifier() == Instruction::Modifier::FLOATING_UNORDERED)
+                return false;
+            emit_operand_address(code, begin + 1U);
+            emit_rex(code, num_bytes(0U));
+            emit_bytes(code, { 0x8BU, 0x06U }); // mov eax, [rsi]
+            emit_operand_address(code, begin + 2U);
+            emit_rex(code, num_bytes(0U));
+            switch (instruction.opcode())
+            {
+                case Instruction::Opcode::ADD: emit_bytes(code, { 0x03U, 0x06U }); break; // add eax, [rsi]
+                case Instruction::Opcode::SUB: emit_bytes(code, { 0x2BU, 0x06U }); break; // sub eax, [rsi]
+                case Instruction::Opcode::MUL: emit_bytes(code, { 0x0FU, 0xAFU, 0x06U }); break; // imul eax, [rsi]
+                case Instruction::Opcode::AND: emit_bytes(code, { 0x23U, 0x06U }); break; // and eax, [rsi]
+                case Instruction::Opcode::OR: emit_bytes(code, { 0x0BU, 0x06U }); break; // or eax, [rsi]
+                case Instruction::Opcode::XOR: emit_bytes(code, { 0x33U, 0x06U }); break; // xor eax, [rsi]
+                default: UNREACHABLE(); break;
+            }
+            emit_operand_address(code, begin);
+            emit_rex(code, num_bytes(0U));
+            emit_bytes(code, { 0x89U, 0x06U }); // mov [rsi], eax
+            return true;
+        }
+
+        case Instruction::Opcode::LESS:
+        case Instruction::Opcode::LESS_EQUAL:
+        case Instruction::Opcode::GREATER:
+        case Instruction::Opcode::GREATER_EQUAL:
+        case Instruction::Opcode::EQUAL:
+        case Instruction::Opcode::UNEQUAL:
+        {
+            std::uint8_t const setcc{ setcc_opcode(instruction.opcode(), instruction.modifier()) };
+            if (setcc == 0U || num_operands != 3U || num_bytes(0U) != 1ULL ||
+                    (num_bytes(1U) != 4ULL && num_bytes(1U) != 8ULL) || num_bytes(2U) != num_bytes(1U))
+                return false;
+            emit_operand_address(code, begin + 1U);
+            emit_rex(code, num_bytes(1U));
+            emit_bytes(code, { 0x8BU, 0x16U }); // mov edx, [rsi]
+            emit_operand_address(code, begin + 2U);
+            emit_rex(code, num_bytes(1U));
+            emit_bytes(code, { 0x3BU, 0x16U }); // cmp edx, [rsi]
+            emit_bytes(code, { 0x0FU, setcc, 0xC0U }); // setcc al
+            emit_operand_address(code, begin);
+            emit_bytes(code, { 0x88U, 0x06U }); // mov [rsi], al
+            return true;
+        }
+
+        case Instruction::Opcode::JUMP:
+            emit_bytes(code, { 0xB8U }); // mov eax, imm32
+            emit_uint32(code, decoded.successors.front());
+            emit_bytes(code, { 0xC3U }); // ret
+            return true;
+
+        case Instruction::Opcode::BRANCH:
+            if (num_operands != 1U)
+                return false;
+            emit_operand_address(code, begin);
+            emit_bytes(code, { 0x80U, 0x3EU, 0x00U }); // cmp byte [rsi], 0
+            emit_bytes(code, { 0xB8U }); // mov eax, imm32
+            emit_uint32(code, decoded.successors.front());
+            emit_bytes(code, { 0xBAU }); // mov edx, imm32
+            emit_uint32(code, decoded.successors.back());
+            emit_bytes(code, { 0x0FU, 0x45U, 0xC2U }); // cmovne eax, edx
+            emit_bytes(code, { 0xC3U }); // ret
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+bool Jit::is_supported()
+{
+#if defined(SALA_JIT_X86_64_LINUX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+Jit::Jit(DecodedProgram const* const decoded_program, std::uint32_t const hot_threshold)
+    : decoded_program_{ decoded_program }
+    , hot_threshold_{ hot_threshold }
+    , blocks_{}
+    , num_compiled_blocks_{ 0ULL }
+    , pages_{}
+    , page_cursor_{ 0ULL }
+{
+    blocks_.reserve(decoded_program_->functions().size());
+    for (DecodedFunction const& decoded_function : decoded_program_->functions())
+        blocks_.push_back(std::vector<Block>(decoded_function.function().basic_blocks().size()));
+}
+
+
+Jit::~Jit()
+{
+#if defined(SALA_JIT_X86_64_LINUX)
+    for (auto const& page : pages_)
+        munmap(page.first, page.second);
+#endif
+}
+
+
+void Jit::add_native_block(std::uint32_t const func_idx, std::uint32_t const block_idx, Code const code, std::uint32_t const num_instructions)
+{
+    ASSUMPTION(code != nullptr && num_instructions > 0U);
+    Block& block{ blocks_.at(func_idx).at(block_idx) };
+    block.code = code;
+    block.num_instructions = num_instructions;
+    block.visited = true;
+}
+
+
+Jit::Block const* Jit::compile(std::uint32_t const func_idx, std::uint32_t const block_idx)
+{
+    Block& block{ blocks_[func_idx][block_idx] };
+    block.visited = true;
+    if (!is_supported())
+        return nullptr;
+
+    DecodedFunction const& decoded_function{ decoded_program_->function(func_idx) };
+    std::size_t const num_instructions{ decoded_function.function().basic_blocks().at(block_idx).instructions().size() };
+    if (num_instructions == 0ULL || decoded_function.operands().size() >= (1ULL << 28U))
+        return nullptr;
+
+    std::vector<std::uint8_t> code;
+    for (std::size_t i = 0ULL; i != num_instructions; ++i)
+        if (!emit_instruction(decoded_function, decoded_function.instruction(block_idx, (std::uint32_t)i), i + 1ULL == num_instructions, code))
+            return nullptr;
+
+    block.code = install(code);
+    if (block.code == nullptr)
+        return nullptr;
+    block.num_instructions = (std::uint32_t)num_instructions;
+    ++num_compiled_blocks_;
+    return &block;
+}
+
+
+Jit::Code Jit::install(std::vector<std::uint8_t> const& code)
+{
+#if defined(SALA_JIT_X86_64_LINUX)
+    static std::size_t const page_bytes{ 64ULL * 1024ULL };
+
+    if (pages_.empty() || page_cursor_ + code.size() > pages_.back().second)
+    {
+        std::size_t const num_bytes{ std::max<std::size_t>(page_bytes, (code.size() + page_bytes - 1ULL) & ~(page_bytes - 1ULL)) };
+        void* const ptr{ mmap(nullptr, num_bytes, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+        if (ptr == MAP_FAILED)
+            return nullptr;
+        pages_.push_back({ (std::uint8_t*)ptr, num_bytes });
+        page_cursor_ = 0ULL;
+    }
+
+    std::uint8_t* const page{ pages_.back().first };
+    if (mprotect(page, pages_.back().second, PROT_READ | PROT_WRITE) != 0)
+        return nullptr;
+    std::memcpy(page + page_cursor_, code.data(), code.size());
+    if (mprotect(page, pages_.back().second, PROT_READ | PROT_EXEC) != 0)
+        return nullptr;
+
+    Code const result{ (Code)(void*)(page + page_cursor_) };
+    page_cursor_ += (code.size() + 15ULL) & ~15ULL;
+    return result;
+#else
+    (void)code;
+    return nullptr;
+#endif
+}
+
+
+}
@@ -1,18 +1,60 @@
 #include <sala/memblock.hpp>
 #include <utility/invariants.hpp>
+#include <algorithm>
 #include <cstring>
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <new>
 #include <cstdint>
 
 namespace sala::detail {
 
 
-MemBlockData::MemBlockData(PointerModel* const pointer_model, std::size_t const num_bytes, std::uint8_t const init_value)
+static std::size_t align_up(std::size_t const num_bytes, std::size_t const alignment)
+{
+    return (num_bytes + alignment - 1ULL) & ~(alignment - 1ULL);
+}
+
+
+static std::size_t constexpr data_bytes{ memblock_bytes_offset };
+
+
+// The memory of a slab is: the slab, then the data of all its blocks, and then the bytes of all the blocks.
+struct MemBlockSlab final
+{
+    MemBlockAllocator* allocator;
+    std::size_t num_bytes;
+    std::size_t num_live_blocks;
+
+    MemBlockData* blocks() { return (MemBlockData*)((std::uint8_t*)this + header_bytes()); }
+    void release() { if (--num_live_blocks == 0ULL) allocator->deallocate(this, num_bytes); }
+
+    static std::size_t header_bytes() { return align_up(sizeof(MemBlockSlab), MemBlockAllocator::alignment); }
+};
+
+
+MemBlockData* MemBlockData::create(MemBlockAllocator* const allocator, PointerModel* const pointer_model, std::size_t const num_bytes)
+{
+    // Even an empty block occupies a byte, so that all blocks have different start addresses.
+    void* const memory{ allocator->allocate(data_bytes + std::max<std::size_t>(num_bytes, 1ULL)) };
+    return new (memory) MemBlockData{ pointer_model, (std::uint8_t*)memory + data_bytes, num_bytes, allocator, nullptr };
+}
+
+
+MemBlockData::MemBlockData(
+    PointerModel* const pointer_model,
+    MemPtr const bytes_ptr,
+    std::size_t const num_bytes,
+    MemBlockAllocator* const allocator,
+    MemBlockSlab* const slab
+    )
     : pointer_model_{ pointer_model }
-    , bytes{ new std::uint8_t[num_bytes] }
+    , bytes{ bytes_ptr }
     , count_{ num_bytes }
+    , ref_count_{ 1ULL }
+    , allocator_{ allocator }
+    , slab_{ slab }
 {
     pointer_model_->on_memblock_allocated(bytes, count_);
 }
@@ -24,23 +66,99 @@ MemBlockData::~MemBlockData()
 }
 
 
+void MemBlockData::destroy()
+{
+    MemBlockAllocator* const allocator{ allocator_ };
+    MemBlockSlab* const slab{ slab_ };
+    std::size_t const num_bytes{ data_bytes + std::max<std::size_t>(count_, 1ULL) };
+    this->~MemBlockData();
+    if (slab != nullptr)
+        slab->release();
+    else
+        allocator->deallocate(this, num_bytes);
+}
+
+
 }
 
 namespace sala {
 
 
-MemBlock::MemBlock()
-    : data_{}
+MemBlock::MemBlock(PointerModel* const pointer_model, std::size_t const num_bytes, std::uint8_t const init_value)
+    : MemBlock{ MemBlockAllocator::heap(), pointer_model, num_bytes, init_value }
 {}
 
 
-MemBlock::MemBlock(PointerModel* const pointer_model, std::size_t const num_bytes, std::uint8_t const init_value)
-    : data_{ std::make_shared<detail::MemBlockData>(pointer_model, num_bytes, init_value) }
+MemBlock::MemBlock(MemBlockAllocator* const allocator, PointerModel* const pointer_model, std::size_t const num_bytes, std::uint8_t const init_value)
+    : data_{ detail::MemBlockData::create(allocator, pointer_model, num_bytes) }
 {
     std::memset(start(), init_value, count());
 }
 
 
+void MemBlock::push_back_slab(
+    MemBlockAllocator* const allocator,
+    PointerModel* const pointer_model,
+    std::vector<std::size_t> const& sizes,
+    std::vector<MemBlock>& blocks,
+    std::uint8_t const init_value
+    )
+{
+    if (sizes.empty())
+        return;
+
+    std::size_t const bytes_offset{ detail::MemBlockSlab::header_bytes() + sizes.size() * sizeof(detail::MemBlockData) };
+    std::vector<std::size_t> offsets;
+    offsets.reserve(sizes.size());
+    std::size_t num_bytes{ bytes_offset };
+    for (std::size_t const size : sizes)
+    {
+        std::size_t alignment{ 1ULL };
+        while (alignment < MemBlockAllocator::alignment && 2ULL * alignment <= size)
+            alignment *= 2ULL;
+        num_bytes = detail::align_up(num_bytes, alignment);
+        offsets.push_back(num_bytes);
+        // At least one byte of padding follows each block, so that a pointer one past the end
+        // of a block never points to the next block (for the Sanitizer and for pointer models).
+        num_bytes += size + 1ULL;
+    }
+
+    std::uint8_t* const memory{ (std::uint8_t*)allocator->allocate(num_bytes) };
+    std::memset(memory + bytes_offset, init_value, num_bytes - bytes_offset);
+    detail::MemBlockSlab* const slab{ new (memory) detail::MemBlockSlab{ allocator, num_bytes, sizes.size() } };
+    for (std::size_t i = 0ULL; i != sizes.size(); ++i)
+    {
+        detail::MemBlockData* const data{ new (slab->blocks() + i) detail::MemBlockData{
+                pointer_model, memory + offsets.at(i), sizes.at(i), allocator, slab
+                } };
+        blocks.push_back(MemBlock{ data });
+    }
+}
+
+
+void MemBlock::push_back_views(
+    MemBlockAllocator* const allocator,
+    PointerModel* const pointer_model,
+    std::vector<std::pair<MemPtr, std::size_t> > const& ranges,
+    std::vector<MemBlock>& blocks
+    )
+{
+    if (ranges.empty())
+        return;
+
+    std::size_t const num_bytes{ detail::MemBlockSlab::header_bytes() + ranges.size() * sizeof(detail::MemBlockData) };
+    std::uint8_t* const memory{ (std::uint8_t*)allocator->allocate(num_bytes) };
+    detail::MemBlockSlab* const slab{ new (memory) detail::MemBlockSlab{ allocator, num_bytes, ranges.size() } };
+    for (std::size_t i = 0ULL; i != ranges.size(); ++i)
+    {
+        detail::MemBlockData* const data{ new (slab->blocks() + i) detail::MemBlockData{
+                pointer_model, ranges.at(i).first, ranges.at(i).second, allocator, slab
+                } };
+        blocks.push_back(MemBlock{ data });
+    }
+}
+
+
 std::size_t MemBlock::as_size() const
 {
     switch (count())
@@ -0,0 +1,411 @@
+#include <sala/memblock_allocator.hpp>
+#include <utility/assumptions.hpp>
+#include <new>
+#include <mutex>
+#include <thread>
+#if defined(_WIN32)
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#endif
+#if defined(__linux__)
+#   include <signal.h>
+#   include <unistd.h>
+#endif
+
+namespace sala {
+
+
+static void* allocate_aligned(std::size_t const num_bytes)
+{
+    return ::operator new(num_bytes, std::align_val_t{ MemBlockAllocator::alignment });
+}
+
+
+static void deallocate_aligned(void* const ptr)
+{
+    ::operator delete(ptr, std::align_val_t{ MemBlockAllocator::alignment });
+}
+
+
+static std::size_t align_up(std::size_t const num_bytes)
+{
+    return (num_bytes + MemBlockAllocator::alignment - 1ULL) & ~(MemBlockAllocator::alignment - 1ULL);
+}
+
+
+void* MemBlockAllocator::allocate_chunk(std::size_t const num_bytes)
+{
+    return ::operator new(num_bytes, std::align_val_t{ num_bytes });
+}
+
+
+void MemBlockAllocator::deallocate_chunk(void* const ptr, std::size_t const num_bytes)
+{
+    ::operator delete(ptr, std::align_val_t{ num_bytes });
+}
+
+
+MemBlockAllocator* MemBlockAllocator::heap()
+{
+    static MemBlockAllocatorHeap allocator;
+    return &allocator;
+}
+
+
+void* MemBlockAllocatorHeap::allocate(std::size_t const num_bytes)
+{
+    return allocate_aligned(num_bytes);
+}
+
+
+void MemBlockAllocatorHeap::deallocate(void* const ptr, std::size_t)
+{
+    deallocate_aligned(ptr);
+}
+
+
+MemBlockAllocatorPools::MemBlockAllocatorPools()
+    : free_lists_{}
+    , chunks_{}
+    , chunk_cursor_{ nullptr }
+    , chunk_end_{ nullptr }
+{
+    free_lists_.fill(nullptr);
+}
+
+
+MemBlockAllocatorPools::~MemBlockAllocatorPools()
+{
+    for (void* const chunk : chunks_)
+        deallocate_aligned(chunk);
+}
+
+
+std::size_t MemBlockAllocatorPools::size_class(std::size_t const num_bytes)
+{
+    std::size_t idx{ 0ULL };
+    for (std::size_t class_bytes = MemBlockAllocator::alignment; class_bytes < num_bytes; class_bytes *= 2ULL)
+        ++idx;
+    return idx;
+}
+
+
+void* MemBlockAllocatorPools::allocate(std::size_t const num_bytes)
+{
+    if (num_bytes > max_pooled_bytes)
+        return allocate_aligned(num_bytes);
+
+    std::size_t const idx{ size_class(num_bytes) };
+    if (free_lists_.at(idx) != nullptr)
+    {
+        FreeNode* const node{ free_lists_.at(idx) };
+        free_lists_.at(idx) = node->next;
+        return node;
+    }
+
+    std::size_t const class_bytes{ MemBlockAllocator::alignment << idx };
+    if ((std::size_t)(chunk_end_ - chunk_cursor_) < class_bytes)
+    {
+        chunks_.push_back(allocate_aligned(chunk_bytes));
+        chunk_cursor_ = (std::uint8_t*)chunks_.back();
+        chunk_end_ = chunk_cursor_ + chunk_bytes;
+    }
+    void* const ptr{ chunk_cursor_ };
+    chunk_cursor_ += class_bytes;
+    return ptr;
+}
+
+
+void MemBlockAllocatorPools::deallocate(void* const ptr, std::size_t const num_bytes)
+{
+    if (num_bytes > max_pooled_bytes)
+    {
+        deallocate_aligned(ptr);
+        return;
+    }
+
+    std::size_t const idx{ size_class(num_bytes) };
+    FreeNode* const node{ (FreeNode*)ptr };
+    node->next = free_lists_.at(idx);
+    free_lists_.at(idx) = node;
+}
+
+
+MemBlockAllocatorArena::MemBlockAllocatorArena()
+    : chunks_{}
+    , chunk_cursor_{ nullptr }
+    , chunk_end_{ nullptr }
+    , num_reserved_bytes_{ 0ULL }
+{}
+
+
+MemBlockAllocatorArena::~MemBlockAllocatorArena()
+{
+    for (void* const chunk : chunks_)
+        deallocate_aligned(chunk);
+}
+
+
+void* MemBlockAllocatorArena::allocate(std::size_t const num_bytes)
+{
+    std::size_t const aligned_bytes{ align_up(num_bytes) };
+    if (aligned_bytes > chunk_bytes / 4ULL)
+    {
+        chunks_.push_back(allocate_aligned(aligned_bytes));
+        num_reserved_bytes_ += aligned_bytes;
+        return chunks_.back();
+    }
+    if ((std::size_t)(chunk_end_ - chunk_cursor_) < aligned_bytes)
+    {
+        chunks_.push_back(allocate_aligned(chunk_bytes));
+        num_reserved_bytes_ += chunk_bytes;
+        chunk_cursor_ = (std::uint8_t*)chunks_.back();
+        chunk_end_ = chunk_cursor_ + chunk_bytes;
+    }
+    void* const ptr{ chunk_cursor_ };
+    chunk_cursor_ += aligned_bytes;
+    return ptr;
+}
+
+
+MemBlockAllocatorFlat::MemBlockAllocatorFlat(std::size_t const num_region_bytes, bool const enable_write_tracking)
+    : begin_{ nullptr }
+    , end_{ nullptr }
+    , cursor_{ nullptr }
+    , committed_end_{ nullptr }
+    , free_lists_{}
+    , free_pages_{}
+    , free_chunks_{}
+    , write_tracking_enabled_{ enable_write_tracking }
+    , tracked_end_{ nullptr }
+    , tracking_epoch_{ 0ULL }
+    , tracking_page_bytes_{ page_bytes }
+    , dirty_pages_{}
+    , num_dirty_pages_{ 0ULL }
+{
+    ASSUMPTION(num_region_bytes > page_bytes && num_region_bytes % page_bytes == 0ULL);
+#if defined(_WIN32)
+    void* const region{ VirtualAlloc(nullptr, num_region_bytes, MEM_RESERVE, PAGE_NOACCESS) };
+    if (region == nullptr)
+        throw std::bad_alloc{};
+    committed_end_ = (std::uint8_t*)region;
+#else
+    void* const region{ mmap(nullptr, num_region_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0) };
+    if (region == MAP_FAILED)
+        throw std::bad_alloc{};
+    committed_end_ = (std::uint8_t*)region + num_region_bytes;
+#endif
+    begin_ = (std::uint8_t*)region;
+    end_ = begin_ + num_region_bytes;
+    cursor_ = begin_ + page_bytes;
+    free_lists_.fill(nullptr);
+}
+
+
+MemBlockAllocatorFlat::~MemBlockAllocatorFlat()
+{
+    for (auto& slot : tracking_slots_)
+    {
+        MemBlockAllocatorFlat* self{ this };
+        if (slot.allocator.compare_exchange_strong(self, nullptr))
+            // A handler of a write fault on another thread may still use the allocator.
+            while (slot.num_users.load() != 0U)
+                std::this_thread::yield();
+    }
+#if defined(_WIN32)
+    VirtualFree(begin_, 0, MEM_RELEASE);
+#else
+    munmap(begin_, end_ - begin_);
+#endif
+}
+
+
+std::size_t MemBlockAllocatorFlat::size_class(std::size_t const num_bytes)
+{
+    std::size_t idx{ 0ULL };
+    for (std::size_t class_bytes = MemBlockAllocator::alignment; class_bytes < num_bytes; class_bytes *= 2ULL)
+        ++idx;
+    return idx;
+}
+
+
+std::uint8_t* MemBlockAllocatorFlat::bump(std::size_t const num_bytes, std::size_t const alignment)
+{
+    std::uint8_t* const ptr{ begin_ + (((std::size_t)(cursor_ - begin_) + alignment - 1ULL) & ~(alignment - 1ULL)) };
+    if (ptr > end_ || (std::size_t)(end_ - ptr) < num_bytes)
+        throw std::bad_alloc{};
+#if defined(_WIN32)
+    if (ptr + num_bytes > committed_end_)
+    {
+        std::size_t constexpr commit_bytes{ 1024ULL * 1024ULL };
+        std::uint8_t* new_end{ begin_ + ((ptr + num_bytes - begin_ + commit_bytes - 1ULL) / commit_bytes) * commit_bytes };
+        if (new_end > end_)
+            new_end = end_;
+        if (VirtualAlloc(committed_end_, new_end - committed_end_, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+            throw std::bad_alloc{};
+        committed_end_ = new_end;
+    }
+#endif
+    cursor_ = ptr + num_bytes;
+    return ptr;
+}
+
+
+void* MemBlockAllocatorFlat::allocate(std::size_t const num_bytes)
+{
+    if (num_bytes > max_pooled_bytes)
+    {
+        std::size_t const pages_bytes{ (num_bytes + page_bytes - 1ULL) & ~(page_bytes - 1ULL) };
+        auto const it = free_pages_.find(pages_bytes);
+        if (it != free_pages_.end() && !it->second.empty())
+        {
+            void* const ptr{ it->second.back() };
+            it->second.pop_back();
+            return ptr;
+        }
+        return bump(pages_bytes, page_bytes);
+    }
+
+    std::size_t const idx{ size_class(num_bytes) };
+    if (free_lists_.at(idx) != nullptr)
+    {
+        FreeNode* const node{ free_lists_.at(idx) };
+        free_lists_.at(idx) = node->next;
+        return node;
+    }
+    std::size_t const class_bytes{ MemBlockAllocator::alignment << idx };
+    return bump(class_bytes, MemBlockAllocator::alignment);
+}
+
+
+void MemBlockAllocatorFlat::deallocate(void* const ptr, std::size_t const num_bytes)
+{
+    if (num_bytes > max_pooled_bytes)
+    {
+        free_pages_[(num_bytes + page_bytes - 1ULL) & ~(page_bytes - 1ULL)].push_back(ptr);
+        return;
+    }
+
+    std::size_t const idx{ size_class(num_bytes) };
+    FreeNode* const node{ (FreeNode*)ptr };
+    node->next = free_lists_.at(idx);
+    free_lists_.at(idx) = node;
+}
+
+
+void* MemBlockAllocatorFlat::allocate_chunk(std::size_t const num_bytes)
+{
+    auto const it = free_chunks_.find(num_bytes);
+    if (it != free_chunks_.end() && !it->second.empty())
+    {
+        void* const ptr{ it->second.back() };
+        it->second.pop_back();
+        return ptr;
+    }
+    return bump(num_bytes, num_bytes);
+}
+
+
+void MemBlockAllocatorFlat::deallocate_chunk(void* const ptr, std::size_t const num_bytes)
+{
+    free_chunks_[num_bytes].push_back(ptr);
+}
+
+
+std::array<MemBlockAllocatorFlat::TrackingSlot, MemBlockAllocatorFlat::max_tracking_allocators> MemBlockAllocatorFlat::tracking_slots_{};
+
+
+bool MemBlockAllocatorFlat::on_write_fault(void* const address)
+{
+#if defined(__linux__)
+    for (auto& slot : tracking_slots_)
+    {
+        ++slot.num_users;
+        MemBlockAllocatorFlat* const allocator{ slot.allocator.load() };
+        if (allocator == nullptr || (std::uint8_t*)address < allocator->begin_ || (std::uint8_t*)address >= allocator->tracked_end_)
+        {
+            --slot.num_users;
+            continue;
+        }
+        std::size_t const page{ (std::size_t)((std::uint8_t*)address - allocator->begin_) / allocator->tracking_page_bytes_ };
+        bool const unprotected{ mprotect(allocator->begin_ + page * allocator->tracking_page_bytes_, allocator->tracking_page_bytes_, PROT_READ | PROT_WRITE) == 0 };
+        if (unprotected)
+            allocator->dirty_pages_[allocator->num_dirty_pages_++] = page;
+        --slot.num_users;
+        return unprotected;
+    }
+#endif
+    return false;
+}
+
+
+bool MemBlockAllocatorFlat::track_writes()
+{
+    if (!write_tracking_enabled())
+        return false;
+#if defined(__linux__)
+    static struct sigaction previous_action;
+    static bool handler_installed{ false };
+    static std::once_flag install_flag;
+    std::call_once(install_flag, []() {
+        struct sigaction action{};
+        action.sa_sigaction = [](int const signal_number, siginfo_t* const info, void* const context) {
+            if (on_write_fault(info->si_addr))
+                return;
+            if ((previous_action.sa_flags & SA_SIGINFO) != 0)
+                previous_action.sa_sigaction(signal_number, info, context);
+            else if (previous_action.sa_handler == SIG_DFL || previous_action.sa_handler == SIG_IGN)
+                signal(signal_number, SIG_DFL);
+            else
+                previous_action.sa_handler(signal_number);
+        };
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        handler_installed = sigaction(SIGSEGV, &action, &previous_action) == 0;
+    });
+    if (!handler_installed)
+        return false;
+
+    if (!tracks_writes())
+    {
+        bool registered{ false };
+        for (auto& slot : tracking_slots_)
+        {
+            MemBlockAllocatorFlat* empty{ nullptr };
+            if (slot.allocator.compare_exchange_strong(empty, this))
+            {
+                registered = true;
+                break;
+            }
+        }
+        if (!registered)
+            return false;
+        tracking_page_bytes_ = (std::size_t)sysconf(_SC_PAGESIZE);
+    }
+
+    std::size_t const num_pages{ ((std::size_t)(cursor_ - begin_) + tracking_page_bytes_ - 1ULL) / tracking_page_bytes_ };
+    if (tracked_end_ == nullptr || begin_ + num_pages * tracking_page_bytes_ > tracked_end_)
+        dirty_pages_ = std::make_unique<std::size_t[]>(num_pages);
+    num_dirty_pages_ = 0ULL;
+    tracked_end_ = begin_ + num_pages * tracking_page_bytes_;
+    mprotect(begin_, tracked_end_ - begin_, PROT_READ);
+    ++tracking_epoch_;
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+void MemBlockAllocatorFlat::protect_dirty_pages()
+{
+#if defined(__linux__)
+    for (std::size_t i = 0ULL, n = num_dirty_pages_; i != n; ++i)
+        mprotect(dirty_page(i), tracking_page_bytes_, PROT_READ);
+#endif
+    num_dirty_pages_ = 0ULL;
+}
+
+
+}
@@ -299,4 +299,92 @@ void PointerModelM32_SegmentOffset::write_pointer_as_uint64(MemPtr const to, Mem
 }
 
 
+PointerModelM32_FlatOffset::PointerModelM32_FlatOffset(MemPtr const region_begin, MemPtr const region_end)
+    : region_begin_{ region_begin }
+    , region_end_{ region_end }
+{
+    // The offset of the end of the region (a pointer one past the end of the last block) must fit to 32 bits.
+    ASSUMPTION(region_begin_ < region_end_ && (std::size_t)(region_end_ - region_begin_) <= std::numeric_limits<MemPtr32bit>::max());
+}
+
+
+std::size_t PointerModelM32_FlatOffset::sizeof_pointer()
+{
+    return sizeof(MemPtr32bit);
+}
+
+
+PointerModelM32_FlatOffset::MemPtr32bit PointerModelM32_FlatOffset::to_offset(MemPtr const ptr) const
+{
+    return region_begin_ < ptr && ptr <= region_end_ ? (MemPtr32bit)(ptr - region_begin_) : nullptr_32bit;
+}
+
+
+MemPtr PointerModelM32_FlatOffset::read_pointer(MemPtr const from)
+{
+    MemPtr32bit const ptr32bit{ *(MemPtr32bit*)from };
+    return ptr32bit == nullptr_32bit ? nullptr : region_begin_ + ptr32bit;
+}
+
+
+void PointerModelM32_FlatOffset::write_pointer(MemPtr const to, MemPtr const ptr)
+{
+    *(MemPtr32bit*)to = to_offset(ptr);
+}
+
+
+void PointerModelM32_FlatOffset::read_shift_and_write(MemPtr const to, MemPtr const from, std::int64_t const shift)
+{
+    *(MemPtr32bit*)to = (MemPtr32bit)(*(MemPtr32bit*)from + shift);
+}
+
+
+void PointerModelM32_FlatOffset::write_uint8_as_pointer(MemPtr const to, std::uint8_t const int_ptr)
+{
+    *(MemPtr32bit*)to = (MemPtr32bit)int_ptr;
+}
+
+
+void PointerModelM32_FlatOffset::write_uint16_as_pointer(MemPtr const to, std::uint16_t const int_ptr)
+{
+    *(MemPtr32bit*)to = (MemPtr32bit)int_ptr;
+}
+
+
+void PointerModelM32_FlatOffset::write_uint32_as_pointer(MemPtr const to, std::uint32_t const int_ptr)
+{
+    *(MemPtr32bit*)to = (MemPtr32bit)int_ptr;
+}
+
+
+void PointerModelM32_FlatOffset::write_uint64_as_pointer(MemPtr const to, std::uint64_t const int_ptr)
+{
+    *(MemPtr32bit*)to = (MemPtr32bit)int_ptr;
+}
+
+
+void PointerModelM32_FlatOffset::write_pointer_as_uint8(MemPtr const to, MemPtr const ptr)
+{
+    *(std::uint8_t*)to = (std::uint8_t)to_offset(ptr);
+}
+
+
+void PointerModelM32_FlatOffset::write_pointer_as_uint16(MemPtr const to, MemPtr const ptr)
+{
+    *(std::uint16_t*)to = (std::uint16_t)to_offset(ptr);
+}
+
+
+void PointerModelM32_FlatOffset::write_pointer_as_uint32(MemPtr const to, MemPtr const ptr)
+{
+    *(std::uint32_t*)to = (std::uint32_t)to_offset(ptr);
+}
+
+
+void PointerModelM32_FlatOffset::write_pointer_as_uint64(MemPtr const to, MemPtr const ptr)
+{
+    *(std::uint64_t*)to = (std::uint64_t)to_offset(ptr);
+}
+
+
 }
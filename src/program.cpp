@@ -5,8 +5,27 @@
 namespace sala {
 
 
+void Constant::assume_not_frozen() const
+{
+    ASSUMPTION(program() == nullptr || !program()->is_frozen());
+}
+
+
+void Variable::assume_not_frozen() const
+{
+    ASSUMPTION(program() == nullptr || !program()->is_frozen());
+}
+
+
+void Instruction::assume_not_frozen() const
+{
+    ASSUMPTION(program() == nullptr || !program()->is_frozen());
+}
+
+
 void Instruction::push_back_operand(std::uint32_t const operand, Descriptor const descriptor)
 {
+    assume_not_frozen();
     operands_.push_back(operand);
     descriptors_.push_back(descriptor);
 }
@@ -14,6 +33,7 @@ void Instruction::push_back_operand(std::uint32_t const operand, Descriptor cons
 
 void Instruction::assign(Instruction const& other)
 {
+    assume_not_frozen();
     opcode_ = other.opcode();
     modifier_ = other.modifier();
     operands_ = other.operands();
@@ -22,9 +42,17 @@ void Instruction::assign(Instruction const& other)
 }
 
 
+void BasicBlock::assume_not_frozen() const
+{
+    ASSUMPTION(program() == nullptr || !program()->is_frozen());
+}
+
+
 Instruction& BasicBlock::push_back_instruction()
 {
+    assume_not_frozen();
     instructions_.push_back({});
+    instructions_.back().set_program(program());
     instructions_.back().set_basic_block_index(index());
     instructions_.back().set_index((std::uint32_t)instructions_.size() - 1U);
     return instructions_.back();
@@ -34,33 +62,49 @@ Instruction& BasicBlock::push_back_instruction()
 
 void BasicBlock::pop_back_instruction()
 {
+    assume_not_frozen();
     instructions_.pop_back();
 }
 
 
 void BasicBlock::assign_instruction(std::size_t const index, Instruction const& instruction)
 {
+    assume_not_frozen();
     instructions_.at(index).assign(instruction);
 }
 
 
 std::size_t Function::initial_stack_bytes() const
 {
-    if (initial_stack_bytes_ == std::numeric_limits<std::size_t>::max())
-    {
-        initial_stack_bytes_ = 0ULL;
-        for (auto const& param : parameters())
-            initial_stack_bytes_ += param.num_bytes();
-        for (auto const& local : local_variables())
-            initial_stack_bytes_ += local.num_bytes();
-    }
-    return initial_stack_bytes_;
+    if (initial_stack_bytes_ != std::numeric_limits<std::size_t>::max())
+        return initial_stack_bytes_;
+    std::size_t num_bytes{ 0ULL };
+    for (auto const& param : parameters())
+        num_bytes += param.num_bytes();
+    for (auto const& local : local_variables())
+        num_bytes += local.num_bytes();
+    return num_bytes;
+}
+
+
+void Function::freeze()
+{
+    initial_stack_bytes_ = std::numeric_limits<std::size_t>::max();
+    initial_stack_bytes_ = initial_stack_bytes();
+}
+
+
+void Function::assume_not_frozen() const
+{
+    ASSUMPTION(program() == nullptr || !program()->is_frozen());
 }
 
 
 BasicBlock& Function::push_back_basic_block()
 {
+    assume_not_frozen();
     blocks_.push_back({});
+    blocks_.back().set_program(program());
     blocks_.back().set_function_index(index());
     blocks_.back().set_index((std::uint32_t)blocks_.size() - 1U);
     return blocks_.back();
@@ -69,24 +113,24 @@ BasicBlock& Function::push_back_basic_block()
 
 Variable& Function::push_back_parameter()
 {
+    assume_not_frozen();
     parameters_.push_back({});
     parameters_.back().set_program(program());
     parameters_.back().set_function_index(index());
     parameters_.back().set_index((std::uint32_t)parameters_.size() - 1U);
     parameters_.back().set_region(Variable::Region::STACK);
-    initial_stack_bytes_ = std::numeric_limits<std::size_t>::max();
     return parameters_.back();    
 }
 
 
 Variable& Function::push_back_local_variable()
 {
+    assume_not_frozen();
     locals_.push_back({});
     locals_.back().set_program(program());
     locals_.back().set_function_index(index());
     locals_.back().set_index((std::uint32_t)locals_.size() - 1U);
     locals_.back().set_region(Variable::Region::STACK);
-    initial_stack_bytes_ = std::numeric_limits<std::size_t>::max();
     return locals_.back();    
 }
 
@@ -101,6 +145,7 @@ Program::Program()
     , constants_{}
     , external_variables_{}
     , external_functions_{}
+    , frozen_{ false }
 {}
 
 
@@ -108,8 +153,23 @@ std::uint32_t Program::static_initializer() { return 0U; }
 std::string Program::static_initializer_name() { return "__sala_static_initializer__"; }
 
 
+void Program::assume_not_frozen() const
+{
+    ASSUMPTION(!is_frozen());
+}
+
+
+void Program::freeze()
+{
+    for (auto& func : functions_)
+        func.freeze();
+    frozen_ = true;
+}
+
+
 Function& Program::push_back_function(std::string const& func_name)
 {
+    assume_not_frozen();
     functions_.push_back({});
     functions_.back().set_program(this);
     functions_.back().set_name(func_name);
@@ -120,6 +180,7 @@ Function& Program::push_back_function(std::string const& func_name)
 
 Variable& Program::push_back_static_variable()
 {
+    assume_not_frozen();
     variables_.push_back({});
     variables_.back().set_program(this);
     variables_.back().set_function_index(std::numeric_limits<std::uint32_t>::max());
@@ -131,6 +192,7 @@ Variable& Program::push_back_static_variable()
 
 Constant& Program::push_back_constant()
 {
+    assume_not_frozen();
     constants_.push_back({});
     constants_.back().set_program(this);
     constants_.back().set_index((std::uint32_t)constants_.size() - 1U);
@@ -140,6 +202,7 @@ Constant& Program::push_back_constant()
 
 void Program::push_back_external_variable(std::uint32_t const index, std::string const& name)
 {
+    assume_not_frozen();
     external_variables_.push_back({ index, name });
     variables_.at(index).set_external(true);
 }
@@ -147,6 +210,7 @@ void Program::push_back_external_variable(std::uint32_t const index, std::string
 
 void Program::push_back_external_function(std::uint32_t const index)
 {
+    assume_not_frozen();
     external_functions_.push_back(index);
     functions_.at(index).set_external(true);
 }
@@ -1,4 +1,5 @@
 #include <sala/sanitizer.hpp>
+#include <sala/decoded_program.hpp>
 #include <sala/platform_specifics.hpp>
 #include <utility/assumptions.hpp>
 #include <utility/invariants.hpp>
@@ -10,15 +11,40 @@ namespace sala {
 
 
 Sanitizer::Sanitizer(ExecState* const exec_state)
-    : Analyzer{ exec_state }
+    : Analyzer{ exec_state, opcodes({
+            Instruction::Opcode::LOAD,
+            Instruction::Opcode::STORE,
+            Instruction::Opcode::MEMCPY,
+            Instruction::Opcode::MEMMOVE,
+            Instruction::Opcode::MEMSET,
+            Instruction::Opcode::ALLOCA,
+            Instruction::Opcode::STACKRESTORE,
+            Instruction::Opcode::MALLOC,
+            Instruction::Opcode::FREE,
+            Instruction::Opcode::DIV,
+            Instruction::Opcode::REM,
+            Instruction::Opcode::CALL,
+            Instruction::Opcode::RET,
+            Instruction::Opcode::VA_START,
+            Instruction::Opcode::VA_END,
+            Instruction::Opcode::VA_COPY
+            }) }
     , regions_{}
+    , checked_call_targets_(state().decoded_program().num_call_sites())
 {
+    reset();
+}
+
+
+void Sanitizer::reset()
+{
+    regions_.clear();
     for (auto const& constant : state().constant_segment())
         insert(&constant);
     for (auto const& var : state().static_segment())
         insert(&var);
-    for (auto const& ptr_and_block : state().heap_segment())
-        insert(&ptr_and_block.second);
+    for (auto const& block : state().heap_segment())
+        insert(&block);
     Sanitizer::on_stack_initialized();
 }
 
@@ -232,9 +258,9 @@ void Sanitizer::do_stackrestore()
 void Sanitizer::do_malloc()
 {
     set_post_operation([this]() {
-        auto const it = state().heap_segment().find(operands().front()->read<MemPtr>());
-        if (it != state().heap_segment().end())
-            insert(&it->second);
+        MemBlock const* const block{ state().heap_segment().find(operands().front()->read<MemPtr>()) };
+        if (block != nullptr)
+            insert(block);
     });
 }
 
@@ -245,10 +271,10 @@ void Sanitizer::do_free()
     if (ptr == nullptr)
         return;
 
-    auto const it = state().heap_segment().find(ptr);
-    if (it != state().heap_segment().end())
+    MemBlock const* const block{ state().heap_segment().find(ptr) };
+    if (block != nullptr)
     {
-        erase(&it->second);
+        erase(block);
         return;
     }
 
@@ -372,31 +398,37 @@ void Sanitizer::do_call()
 {
     if (instruction().descriptors().front() != Instruction::Descriptor::FUNCTION)
     {
-        auto const it = state().functions_at_addresses().find(operands().front()->read<MemPtr>());
-        if (it == state().functions_at_addresses().end())
+        ExecState::CallTarget const* const target = state().call_target(operands().front()->read<MemPtr>());
+        if (target == nullptr)
         {
             crash_interpretation("Invalid function pointer.");
             return;
         }
-        Function const& func = program().functions().at(it->second);
-
-        if (operands().size() < func.parameters().size() + 1ULL)
+        // The operands of the call site do not change, so the checks passed for the target once pass always.
+        std::vector<std::uint32_t>& checked = checked_call_targets_.at(state().current_decoded_instruction().call_site);
+        if (std::find(checked.begin(), checked.end(), target->func_idx) == checked.end())
         {
-            crash_interpretation("Too few parameters for calling the function.");
-            return;
-        }
+            Function const& func = program().functions().at(target->func_idx);
 
-        for (std::size_t i = 0ULL; i != func.parameters().size(); ++i)
-            if (operands().at(i + 1ULL)->count() != func.parameters().at(i).num_bytes())
+            if (operands().size() < func.parameters().size() + 1ULL)
             {
-                std::stringstream sstr;
-                sstr << "Parameter " << i << " expects " << func.parameters().at(i).num_bytes()
-                        << " bytes, but the corresponding argument has " << operands().at(i + 1ULL)->count()
-                        << " bytes."
-                        ;
-                crash_interpretation(sstr.str());
+                crash_interpretation("Too few parameters for calling the function.");
                 return;
             }
+
+            for (std::size_t i = 0ULL; i != func.parameters().size(); ++i)
+                if (operands().at(i + 1ULL)->count() != func.parameters().at(i).num_bytes())
+                {
+                    std::stringstream sstr;
+                    sstr << "Parameter " << i << " expects " << func.parameters().at(i).num_bytes()
+                            << " bytes, but the corresponding argument has " << operands().at(i + 1ULL)->count()
+                            << " bytes."
+                            ;
+                    crash_interpretation(sstr.str());
+                    return;
+                }
+            checked.push_back(target->func_idx);
+        }
     }
 
     set_post_operation([this]() {
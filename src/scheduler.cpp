@@ -0,0 +1,142 @@
+#include <sala/scheduler.hpp>
+#include <utility/assumptions.hpp>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sala {
+
+
+Scheduler::Scheduler(std::size_t const num_threads, std::uint64_t const slice_steps)
+    : num_threads_{ num_threads != 0ULL ? num_threads : std::max<std::size_t>(std::thread::hardware_concurrency(), 1ULL) }
+    , slice_steps_{ slice_steps }
+    , on_done_{}
+    , mutex_{}
+    , ready_changed_{}
+    , ready_{}
+    , num_running_{ 0ULL }
+    , next_id_{ 0ULL }
+{
+    ASSUMPTION(slice_steps_ > 0ULL);
+}
+
+
+Scheduler::Id Scheduler::add(Interpreter* const interpreter, Interpreter::Budget const& budget)
+{
+    std::lock_guard<std::mutex> const lock{ mutex_ };
+    Id const id{ next_id_++ };
+    ready_.push_back({ id, interpreter, budget, interpreter->num_steps(), 0.0 });
+    ready_changed_.notify_one();
+    return id;
+}
+
+
+void Scheduler::run()
+{
+    std::exception_ptr error{ nullptr };
+
+    auto const worker = [this, &error]() {
+        std::unique_lock<std::mutex> lock{ mutex_ };
+        while (true)
+        {
+            ready_changed_.wait(lock, [this]() { return !ready_.empty() || num_running_ == 0ULL; });
+            if (ready_.empty())
+                break;
+
+            Task task{ ready_.front() };
+            ready_.pop_front();
+            ++num_running_;
+            lock.unlock();
+
+            bool done;
+            try
+            {
+                done = run_slice(task);
+            }
+            catch (std::exception const& e)
+            {
+                task.interpreter->terminate_run(std::string{ "[EXCEPTION] " } + e.what());
+                done = true;
+            }
+            catch (...)
+            {
+                task.interpreter->terminate_run("[EXCEPTION] An unknown exception was thrown during the execution.");
+                done = true;
+            }
+
+            std::exception_ptr callback_error{ nullptr };
+            if (done && on_done_)
+                try
+                {
+                    on_done_(task.id, *task.interpreter);
+                }
+                catch (...)
+                {
+                    callback_error = std::current_exception();
+                }
+
+            lock.lock();
+            if (callback_error != nullptr && error == nullptr)
+                error = callback_error;
+            if (!done)
+                ready_.push_back(task);
+            --num_running_;
+            ready_changed_.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads_ - 1ULL);
+    for (std::size_t i = 1ULL; i < num_threads_; ++i)
+        threads.push_back(std::thread{ worker });
+    worker();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    if (error != nullptr)
+        std::rethrow_exception(error);
+}
+
+
+bool Scheduler::run_slice(Task& task) const
+{
+    Interpreter& interpreter{ *task.interpreter };
+    if (interpreter.done())
+        return true;
+
+    if (task.budget.stop_flag != nullptr && task.budget.stop_flag->load(std::memory_order_relaxed))
+    {
+        interpreter.terminate_run("[STOPPED] The execution was stopped from outside.");
+        return true;
+    }
+
+    std::uint64_t num_steps{ slice_steps_ };
+    if (task.budget.max_steps != 0ULL)
+    {
+        std::uint64_t const num_executed{ interpreter.num_steps() - task.start_steps };
+        if (num_executed >= task.budget.max_steps)
+        {
+            interpreter.terminate_run("[STEP LIMIT] The budget " + std::to_string(task.budget.max_steps) + " of instructions for the execution was exhausted.");
+            return true;
+        }
+        num_steps = std::min(num_steps, task.budget.max_steps - num_executed);
+    }
+
+    std::chrono::steady_clock::time_point const start_time{ std::chrono::steady_clock::now() };
+    if (interpreter.run_slice(num_steps))
+        return true;
+    task.num_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    if (task.budget.max_seconds > 0.0 && task.num_seconds >= task.budget.max_seconds)
+    {
+        interpreter.terminate_run("[TIME OUT] The time budget " + std::to_string(task.budget.max_seconds) + "s for the execution was exhausted.");
+        return true;
+    }
+    return false;
+}
+
+
+}
@@ -7,11 +7,16 @@
 namespace sala::detail {
 
 
-static bool save_json_comments{ false };
+int json_comments_index()
+{
+    static int const index{ std::ios_base::xalloc() };
+    return index;
+}
+
 
-void enable_json_comments(bool const state)
+static bool save_json_comments(std::ostream& ostr)
 {
-    save_json_comments = state;
+    return ostr.iword(json_comments_index()) != 0L;
 }
 
 
@@ -23,7 +28,7 @@ namespace sala {
 struct DbgLine { std::size_t line_; };
 std::ostream& operator<<(std::ostream& ostr, DbgLine const& line)
 {
-    if (detail::save_json_comments)
+    if (detail::save_json_comments(ostr))
         ostr << " // " << line.line_;
     return ostr;
 }
@@ -121,7 +126,7 @@ static bool save_constants(std::ostream& ostr, std::vector<Constant> const& cons
         if (i != 0U)
         {
             ostr << ',' << DbgLine{i - 1ULL};
-            if (detail::save_json_comments)
+            if (detail::save_json_comments(ostr))
                 ostr << ", #" << constants.at(i - 1ULL).bytes().size();
             ostr << '\n';
         }
@@ -133,7 +138,7 @@ static bool save_constants(std::ostream& ostr, std::vector<Constant> const& cons
     if (!constants.empty())
     {
         ostr << DbgLine{constants.size() - 1ULL};
-        if (detail::save_json_comments)
+        if (detail::save_json_comments(ostr))
             ostr << ", #" << constants.back().bytes().size();
     }
     return !constants.empty();